@@ -0,0 +1,24 @@
+/*
+Proyecto MPI - Búsqueda de llaves DES con estrategia seleccionable
+Grupo 4
+
+Un solo programa para todas las estrategias de reparto del espacio de llaves:
+    bloques:     rangos contiguos por ronda, proporcionales a la velocidad de cada proceso
+    intercalado: bloques pequeños intercalados entre procesos (incremento de size)
+    maestro:     maestro/esclavo con unidades de trabajo y arrendamientos
+    dfs:         recorrido con pila de las llaves rank, rank + size, ...
+    rma:         contador compartido con MPI_Fetch_and_op, sin maestro
+
+Compilar: mpic++ -O2 busqueda.cpp -lcrypto -o build/busqueda.o
+Ejecutar: mpirun -np <n> ./build/busqueda.o <archivo> -e <estrategia> [-m ecb|cbc|cfb|ofb] [-iv <hex>] [-o <posición>] [-t <prefijo>] [-todas <prefijo>] [-objetivos <archivo>] [-des propio|openssl] [-perfil <archivo>]
+Sin MPI:  ./build/busqueda.o <archivo> -e <estrategia> -hilos <n>
+Perfil:   mpirun -np <n> ./build/busqueda.o <archivo> -autoajuste   (escribe busqueda.<host>.perfil)
+Elástico: mpirun -np <n> ./build/busqueda.o <archivo> -e maestro -puerto <archivo de puerto>
+          mpirun -np <m> ./build/busqueda.o <archivo> -e maestro -unirse <archivo de puerto>   (desde otro trabajo)
+*/
+
+#include "busqueda.h"
+
+int main(int argc, char **argv) {
+    return runSearch(argc, argv, STRATEGY_BLOCKS);
+}
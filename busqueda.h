@@ -0,0 +1,3358 @@
+/*
+Proyecto MPI - Búsqueda de llaves DES
+Grupo 4
+
+Componentes comunes de los programas de búsqueda: objetivo y modos de operación, kernels de
+prueba de llaves, traza, fijación a núcleos, terminación y las estrategias de reparto del
+espacio de llaves (bloques, intercalado, maestro/esclavo, dfs y contador RMA), todas sobre la
+capa de transporte de transporte.h. Cada programa incluye este archivo una sola vez y llama
+a runSearch con su estrategia por omisión.
+*/
+
+#ifndef BUSQUEDA_H
+#define BUSQUEDA_H
+
+#include <iostream>
+#include <cstring>
+#include <fstream>
+#include <ctime>
+#include <iomanip>
+#include <openssl/des.h>
+#include <mpi.h>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <unistd.h>
+#include <sstream>
+#include <sched.h>
+#include <utility>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <queue>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <numeric>
+#include <cmath>
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+#include <cerrno>
+#include <csignal>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include "transporte.h"
+#include "des_intercalado.h"
+
+using namespace std;
+
+// Unidad de trabajo entregada a un esclavo, válida hasta deadline
+struct Lease {
+    uint64_t start;
+    uint64_t end;
+    int worker;
+    double deadline;
+};
+
+// Modos de operación soportados para el texto cifrado
+enum CipherMode { MODE_ECB = 0, MODE_CBC = 1, MODE_CFB = 2, MODE_OFB = 3 };
+
+/*
+Función scatterBits
+Parámetros:
+    value: uint64_t, contador denso
+    mask: uint64_t, posiciones de destino
+Descripción:
+    Reparte los bits bajos de value, en orden, en las posiciones marcadas en mask
+    (equivalente a la instrucción pdep de BMI2, que se usa si el compilador la habilita).
+Retorno:
+    uint64_t, valor con los bits repartidos
+*/
+inline uint64_t scatterBits(uint64_t value, uint64_t mask) {
+#ifdef __BMI2__
+    return _pdep_u64(value, mask);
+#else
+    uint64_t result = 0;
+    for (uint64_t bit = 1; mask != 0; bit <<= 1) {
+        if (value & bit) {
+            result |= mask & (~mask + 1);  // Bit libre más bajo que queda
+        }
+        mask &= mask - 1;
+    }
+    return result;
+#endif
+}
+
+/*
+Estructura KeySpace
+Descripción:
+    Espacio de llaves de la búsqueda: bits conocidos (fixed) y bits libres (free). Las
+    estrategias recorren índices densos 0..last y cada índice se convierte en una llave
+    repartiendo sus bits en las posiciones libres, de modo que con n bits libres la búsqueda
+    revisa 2^n llaves. Por omisión todos los bits son libres y la llave es el propio índice.
+*/
+struct KeySpace {
+    uint64_t fixed = 0;
+    uint64_t free = UINT64_MAX;
+    uint64_t last = UINT64_MAX;  // Último índice (2^n - 1)
+
+    uint64_t key(uint64_t index) const {
+        return (free == UINT64_MAX) ? index : (fixed | scatterBits(index, free));
+    }
+};
+
+/*
+Función parseKeySpace
+Parámetros:
+    value: string, "<bits fijos>:<máscara de bits libres>" en hexadecimal
+    space: KeySpace, resultado
+Retorno:
+    bool, false si el formato no es válido
+*/
+bool parseKeySpace(const string& value, KeySpace& space) {
+    size_t colon = value.find(':');
+    if (colon == string::npos || colon == 0 || colon + 1 == value.size() ||
+        value.find_first_not_of("0123456789abcdefABCDEF:") != string::npos || colon > 16 || value.size() - colon - 1 > 16) {
+        return false;
+    }
+
+    space.free = stoull(value.substr(colon + 1), nullptr, 16);
+    space.fixed = stoull(value.substr(0, colon), nullptr, 16) & ~space.free;
+    int free_bits = __builtin_popcountll(space.free);
+    space.last = (free_bits == 64) ? UINT64_MAX : (1ULL << free_bits) - 1;
+    return space.free != 0;
+}
+
+const size_t bloom_min_targets = 1024;  // Objetivos a partir de los cuales se usa el filtro de Bloom
+const int bloom_bits_per_target = 16;    // Tamaño del filtro (~0.1% de falsos positivos con 2 sondas)
+
+/*
+Clase TargetSet
+Descripción:
+    Conjunto de bloques cifrados del modo de varios objetivos: tabla de direccionamiento abierto
+    con sondeo lineal y capacidad potencia de 2 (al menos el doble de objetivos), con un valor
+    ausente del conjunto como marca de casilla vacía. Con muchos objetivos, un filtro de Bloom
+    pequeño (2 sondas, cabe en la caché L1/L2) descarta casi todas las llaves antes de tocar la
+    tabla. Los bloques ya son salidas de DES, así que basta con multiplicar para dispersarlos.
+*/
+class TargetSet {
+public:
+    void build(const vector<uint64_t>& blocks) {
+        int bits = 4;
+        while ((1ULL << bits) < 2 * blocks.size()) {
+            bits++;
+        }
+        shift_ = 64 - bits;
+        mask_ = (1ULL << bits) - 1;
+
+        // Marca de vacío: el menor valor que no es un objetivo
+        vector<uint64_t> sorted(blocks);
+        sort(sorted.begin(), sorted.end());
+        empty_ = 0;
+        for (uint64_t block : sorted) {
+            if (block == empty_) {
+                empty_++;
+            } else if (block > empty_) {
+                break;
+            }
+        }
+
+        slots_.assign(mask_ + 1, empty_);
+        ids_.assign(mask_ + 1, -1);
+        next_.assign(blocks.size(), -1);
+        for (size_t id = 0; id < blocks.size(); id++) {
+            uint64_t h = hash(blocks[id]);
+            while (slots_[h] != empty_ && slots_[h] != blocks[id]) {
+                h = (h + 1) & mask_;
+            }
+            if (slots_[h] == blocks[id]) {
+                // Bloque repetido: se encadena al objetivo anterior con el mismo bloque
+                next_[id] = ids_[h];
+            }
+            slots_[h] = blocks[id];
+            ids_[h] = id;
+        }
+
+        bloom_.clear();
+        if (blocks.size() >= bloom_min_targets) {
+            int bloom_bits = 9;
+            while ((1ULL << bloom_bits) < (uint64_t)bloom_bits_per_target * blocks.size()) {
+                bloom_bits++;
+            }
+            bloom_shift_ = 64 - bloom_bits;
+            bloom_.assign((1ULL << bloom_bits) / 64, 0);
+            for (uint64_t block : blocks) {
+                uint64_t h1, h2;
+                bloomHashes(block, h1, h2);
+                bloom_[h1 >> 6] |= 1ULL << (h1 & 63);
+                bloom_[h2 >> 6] |= 1ULL << (h2 & 63);
+            }
+        }
+    }
+
+    bool usesBloom() const { return !bloom_.empty(); }
+
+    // Prueba de pertenencia del ciclo de búsqueda
+    inline bool contains(uint64_t block) const {
+        if (!bloom_.empty()) {
+            uint64_t h1, h2;
+            bloomHashes(block, h1, h2);
+            if (!((bloom_[h1 >> 6] >> (h1 & 63)) & (bloom_[h2 >> 6] >> (h2 & 63)) & 1)) {
+                return false;
+            }
+        }
+        return find(block) >= 0;
+    }
+
+    // Último objetivo con ese bloque (los demás siguen en nextWithSameBlock), o -1
+    int find(uint64_t block) const {
+        if (block == empty_) {
+            return -1;
+        }
+        for (uint64_t h = hash(block); slots_[h] != empty_; h = (h + 1) & mask_) {
+            if (slots_[h] == block) {
+                return ids_[h];
+            }
+        }
+        return -1;
+    }
+
+    int nextWithSameBlock(int id) const { return next_[id]; }
+
+private:
+    inline uint64_t hash(uint64_t block) const {
+        return (block * 0x9E3779B97F4A7C15ULL) >> shift_;
+    }
+
+    inline void bloomHashes(uint64_t block, uint64_t& h1, uint64_t& h2) const {
+        h1 = (block * 0xC2B2AE3D27D4EB4FULL) >> bloom_shift_;
+        h2 = (block * 0x165667B19E3779F9ULL) >> bloom_shift_;
+    }
+
+    vector<uint64_t> slots_;
+    vector<int> ids_;     // Objetivo de cada casilla
+    vector<int> next_;    // Objetivo anterior con el mismo bloque, -1 si no hay
+    uint64_t empty_ = 0;
+    uint64_t mask_ = 0;
+    int shift_ = 64;
+    vector<uint64_t> bloom_;
+    int bloom_shift_ = 64;
+};
+
+// Objetivo de la búsqueda: texto cifrado, modo y frase clave a verificar
+struct SearchTarget {
+    string cipher_text;
+    string key_phrase;
+    int mode;                 // CipherMode
+    DES_cblock iv;            // Vector de inicialización (CBC, CFB, OFB)
+    long long crib_offset;    // Posición conocida de la frase clave, -1 si se desconoce
+    KeySpace space;           // Bits conocidos y libres de la llave
+    vector<string> extra_phrases;  // Frases adicionales que debe contener un candidato (-c)
+    bool text_plain = false;  // El texto plano es texto (-texto): el verificador exige relleno y bytes imprimibles
+
+    // Modo de varios objetivos (-objetivos): cada llave cifra known_block una vez y el resultado
+    // se busca entre los bloques de todos los objetivos
+    uint64_t known_block = 0;        // Entrada de DES (big-endian)
+    vector<uint64_t> target_blocks;  // Salida esperada de cada objetivo, en el orden del archivo
+    TargetSet target_set;
+
+    bool multiTarget() const { return !target_blocks.empty(); }
+};
+
+/*
+Función parseMode
+Parámetros:
+    name: string, nombre del modo (ecb, cbc, cfb, ofb)
+Retorno:
+    int, modo correspondiente o -1 si no es válido
+*/
+int parseMode(const string& name) {
+    if (name == "ecb") return MODE_ECB;
+    if (name == "cbc") return MODE_CBC;
+    if (name == "cfb") return MODE_CFB;
+    if (name == "ofb") return MODE_OFB;
+    return -1;
+}
+
+/*
+Función makeKeySchedule
+Parámetros:
+    key_num: uint64_t, clave numérica de 64 bits
+    schedule: DES_key_schedule, resultado
+Descripción:
+    Convierte la clave numérica en DES_cblock con el orden de bytes correcto, ajusta la paridad
+    y descarta las claves débiles.
+Retorno:
+    bool, false si la clave es débil o no se pudo establecer
+*/
+bool makeKeySchedule(uint64_t key_num, DES_key_schedule& schedule) {
+    DES_cblock key_block;
+
+    // Convertir el uint64_t key_num en DES_cblock con el orden de bytes correcto
+    for (int i = 0; i < 8; i++) {
+        key_block[i] = (key_num >> (56 - 8 * i)) & 0xFF;
+    }
+
+    // Ajustar la paridad de la clave
+    DES_set_odd_parity(&key_block);
+
+    // Verificar si la clave es débil
+    if (DES_is_weak_key(&key_block)) {
+        return false;
+    }
+
+    // Establecer la clave
+    return DES_set_key_checked(&key_block, &schedule) == 0;
+}
+
+/*
+Función xorBlock
+Parámetros:
+    out: bloque de salida
+    a, b: bloques de 8 bytes
+Descripción:
+    out = a XOR b
+*/
+inline void xorBlock(unsigned char* out, const unsigned char* a, const unsigned char* b) {
+    for (int j = 0; j < 8; j++) {
+        out[j] = a[j] ^ b[j];
+    }
+}
+
+/*
+Función encryptText
+Parámetros:
+    key_num: uint64_t, clave numérica de 64 bits
+    plain_text: string, texto a cifrar
+    cipher_text: string, texto cifrado
+    mode: int, modo de operación
+    iv: DES_cblock, vector de inicialización
+Descripción:
+    Cifra el texto plano usando la clave numérica dada en el modo indicado.
+Retorno:
+    void
+*/
+void encryptText(uint64_t key_num, const string& plain_text, string& cipher_text, int mode, const DES_cblock& iv) {
+    DES_key_schedule schedule;
+
+    if (!makeKeySchedule(key_num, schedule)) {
+        cerr << "La clave ingresada es débil. Por favor, ingrese otra clave." << endl;
+        exit(1);
+    }
+
+    // Ajustar el tamaño del texto cifrado
+    size_t input_length = plain_text.size();
+    size_t padded_length = ((input_length + 7) / 8) * 8;
+    string padded_plain_text = plain_text;
+    padded_plain_text.resize(padded_length, '\0');
+
+    cipher_text.resize(padded_length, '\0');
+
+    const unsigned char* in = (const unsigned char*)padded_plain_text.data();
+    unsigned char* out = (unsigned char*)&cipher_text[0];
+    DES_cblock feedback, block;
+    memcpy(feedback, iv, 8);
+
+    // Cifrar el texto en bloques de 8 bytes
+    for (size_t i = 0; i < padded_length; i += 8) {
+        switch (mode) {
+            case MODE_CBC:
+                xorBlock(block, in + i, feedback);
+                DES_ecb_encrypt(&block, (DES_cblock*)(out + i), &schedule, DES_ENCRYPT);
+                memcpy(feedback, out + i, 8);
+                break;
+            case MODE_CFB:
+                DES_ecb_encrypt(&feedback, &block, &schedule, DES_ENCRYPT);
+                xorBlock(out + i, in + i, block);
+                memcpy(feedback, out + i, 8);
+                break;
+            case MODE_OFB:
+                DES_ecb_encrypt(&feedback, &block, &schedule, DES_ENCRYPT);
+                memcpy(feedback, block, 8);
+                xorBlock(out + i, in + i, block);
+                break;
+            default:
+                DES_ecb_encrypt((const_DES_cblock*)(in + i), (DES_cblock*)(out + i), &schedule, DES_ENCRYPT);
+                break;
+        }
+    }
+}
+
+/*
+Función decryptBlocks
+Parámetros:
+    schedule: DES_key_schedule, clave ya preparada
+    target: SearchTarget, texto cifrado, modo e IV
+    first, last: índices del primer y último bloque a descifrar
+    out: buffer de salida de (last - first + 1) * 8 bytes
+Descripción:
+    Descifra solo los bloques indicados. En ECB, CBC y CFB cada bloque depende únicamente
+    del bloque cifrado anterior, así que se descifra de forma independiente. En OFB el flujo
+    de llave se genera desde el IV hasta el último bloque necesario.
+Retorno:
+    void
+*/
+void decryptBlocks(DES_key_schedule& schedule, const SearchTarget& target, size_t first, size_t last, unsigned char* out) {
+    const unsigned char* in = (const unsigned char*)target.cipher_text.data();
+    DES_cblock block;
+
+    if (target.mode == MODE_OFB) {
+        DES_cblock stream;
+        memcpy(stream, target.iv, 8);
+        for (size_t b = 0; b <= last; b++) {
+            DES_ecb_encrypt(&stream, &block, &schedule, DES_ENCRYPT);
+            memcpy(stream, block, 8);
+            if (b >= first) {
+                xorBlock(out + (b - first) * 8, in + b * 8, block);
+            }
+        }
+        return;
+    }
+
+    for (size_t b = first; b <= last; b++) {
+        const unsigned char* previous = (b == 0) ? target.iv : in + (b - 1) * 8;
+        unsigned char* dest = out + (b - first) * 8;
+
+        switch (target.mode) {
+            case MODE_CBC:
+                DES_ecb_encrypt((const_DES_cblock*)(in + b * 8), &block, &schedule, DES_DECRYPT);
+                xorBlock(dest, block, previous);
+                break;
+            case MODE_CFB:
+                DES_ecb_encrypt((const_DES_cblock*)previous, &block, &schedule, DES_ENCRYPT);
+                xorBlock(dest, in + b * 8, block);
+                break;
+            default:
+                DES_ecb_encrypt((const_DES_cblock*)(in + b * 8), (DES_cblock*)dest, &schedule, DES_DECRYPT);
+                break;
+        }
+    }
+}
+
+/*
+Función decryptText
+Parámetros:
+    key_num: uint64_t, clave numérica de 64 bits
+    target: SearchTarget, texto cifrado, modo e IV
+Descripción:
+    Descifra todo el texto cifrado usando la clave numérica dada.
+Retorno:
+    string, texto descifrado (vacío si la clave es débil)
+*/
+string decryptText(uint64_t key_num, const SearchTarget& target) {
+    DES_key_schedule schedule;
+    if (!makeKeySchedule(key_num, schedule) || target.cipher_text.empty()) {
+        return "";
+    }
+
+    string decrypted_str(target.cipher_text.size(), '\0');
+    decryptBlocks(schedule, target, 0, target.cipher_text.size() / 8 - 1, (unsigned char*)&decrypted_str[0]);
+    return decrypted_str;
+}
+
+/*
+Función tryKey
+Parámetros:
+    key_num: uint64_t, clave numérica de 64 bits
+    target: SearchTarget, texto cifrado, modo y frase clave a buscar
+Descripción:
+    Descifra el texto cifrado usando la clave numérica dada y verifica si contiene la frase clave.
+    Si se conoce la posición de la frase clave solo se descifran los bloques que la cubren.
+Retorno:
+    bool, true si el texto descifrado contiene la frase clave, false en caso contrario
+*/
+bool tryKey(uint64_t key_num, const SearchTarget& target) {
+    DES_key_schedule schedule;
+
+    if (!makeKeySchedule(key_num, schedule)) {
+        // La clave es débil, ignorarla
+        return false;
+    }
+
+    const string& key_phrase = target.key_phrase;
+    size_t input_length = target.cipher_text.size();
+    if (input_length == 0) {
+        return false;
+    }
+
+    // Bloques necesarios para la verificación
+    size_t first = 0;
+    size_t last = input_length / 8 - 1;
+    if (target.crib_offset >= 0) {
+        first = target.crib_offset / 8;
+        last = (target.crib_offset + key_phrase.size() - 1) / 8;
+    }
+
+    vector<unsigned char> decrypted_text((last - first + 1) * 8);
+    decryptBlocks(schedule, target, first, last, decrypted_text.data());
+
+    bool match;
+    if (target.crib_offset >= 0) {
+        match = memcmp(decrypted_text.data() + (target.crib_offset - first * 8), key_phrase.data(), key_phrase.size()) == 0;
+    } else {
+        // Verificar si contiene exactamente la frase clave
+        match = search(decrypted_text.begin(), decrypted_text.end(), key_phrase.begin(), key_phrase.end()) != decrypted_text.end();
+    }
+
+    return match;
+}
+
+// Firma común de los kernels de prueba de llaves
+typedef bool (*KeyTestKernel)(uint64_t key_num, const SearchTarget& target);
+
+// Kernel por lotes: prueba des_lanes llaves y retorna la máscara de las que pasan
+typedef unsigned (*KeyBatchKernel)(const uint64_t* keys, const SearchTarget& target);
+
+const size_t max_fixed_crib = 16;  // Largo máximo de frase clave con kernel especializado
+
+/*
+Función checkedBlocks
+Parámetros:
+    target: SearchTarget, objetivo de la búsqueda
+    first: size_t, primer bloque a descifrar (salida)
+Descripción:
+    Calcula qué bloques se descifran para verificar la frase clave.
+Retorno:
+    size_t, cantidad de bloques
+*/
+size_t checkedBlocks(const SearchTarget& target, size_t& first) {
+    if (target.crib_offset >= 0) {
+        first = target.crib_offset / 8;
+        return (target.crib_offset + target.key_phrase.size() - 1) / 8 - first + 1;
+    }
+    first = 0;
+    return target.cipher_text.size() / 8;
+}
+
+/*
+Función tryKeyFixed
+Parámetros:
+    key_num: uint64_t, clave numérica de 64 bits
+    target: SearchTarget, objetivo de la búsqueda (ECB o CBC)
+Descripción:
+    Variante de tryKey con la cantidad de bloques y el largo de la frase clave fijos en
+    tiempo de compilación, para que el compilador desenrolle los ciclos y mantenga el texto
+    descifrado en registros. El despachador (selectKernel) garantiza que el objetivo
+    coincide con los parámetros de la plantilla.
+Retorno:
+    bool, true si el texto descifrado contiene la frase clave
+*/
+template <bool CBC, size_t BLOCKS, size_t CRIB_LEN>
+bool tryKeyFixed(uint64_t key_num, const SearchTarget& target) {
+    DES_key_schedule schedule;
+
+    if (!makeKeySchedule(key_num, schedule)) {
+        return false;
+    }
+
+    size_t first;
+    checkedBlocks(target, first);
+    const unsigned char* cipher = (const unsigned char*)target.cipher_text.data();
+    const unsigned char* in = cipher + first * 8;
+    const unsigned char* phrase = (const unsigned char*)target.key_phrase.data();
+
+    unsigned char decrypted_text[BLOCKS * 8];
+    for (size_t b = 0; b < BLOCKS; b++) {
+        DES_ecb_encrypt((const_DES_cblock*)(in + b * 8), (DES_cblock*)(decrypted_text + b * 8), &schedule, DES_DECRYPT);
+        if (CBC) {
+            const unsigned char* previous = (first + b == 0) ? target.iv : cipher + (first + b - 1) * 8;
+            xorBlock(decrypted_text + b * 8, decrypted_text + b * 8, previous);
+        }
+    }
+
+    bool match = false;
+    if (target.crib_offset >= 0) {
+        match = memcmp(decrypted_text + (target.crib_offset - first * 8), phrase, CRIB_LEN) == 0;
+    } else {
+        for (size_t pos = 0; pos + CRIB_LEN <= BLOCKS * 8 && !match; pos++) {
+            match = memcmp(decrypted_text + pos, phrase, CRIB_LEN) == 0;
+        }
+    }
+
+    return match;
+}
+
+const size_t max_interleaved_blocks = 64;  // Bloques verificados como máximo con el DES propio
+
+/*
+Función tryKeysDes
+Parámetros:
+    keys: uint64_t[LANES], claves numéricas de 64 bits
+    target: SearchTarget, objetivo de la búsqueda (ECB o CBC)
+Descripción:
+    Variante de tryKey sobre el DES propio de des_intercalado.h: calcula las subllaves y
+    descifra los bloques que cubren la frase clave para LANES llaves a la vez, intercalando
+    las rondas. La permutación inicial de cada bloque cifrado se comparte entre las llaves.
+    Las llaves débiles se descartan solo cuando pasan la comparación, igual que makeKeySchedule.
+Retorno:
+    unsigned, máscara de las llaves cuyo texto descifrado contiene la frase clave
+*/
+template <int LANES>
+unsigned tryKeysDes(const uint64_t* keys, const SearchTarget& target) {
+    size_t first;
+    size_t blocks = checkedBlocks(target, first);
+    const unsigned char* cipher = (const unsigned char*)target.cipher_text.data();
+    const unsigned char* in = cipher + first * 8;
+    const string& phrase = target.key_phrase;
+
+    DesSubkeys subkeys[LANES];
+    desSubkeys<LANES>(keys, subkeys);
+
+    unsigned char decrypted_text[LANES][max_interleaved_blocks * 8];
+    for (size_t b = 0; b < blocks; b++) {
+        uint64_t cipher_block;
+        memcpy(&cipher_block, in + b * 8, 8);
+        uint64_t out[LANES];
+        desDecryptLanes<LANES>(subkeys, desInitialPermutation(__builtin_bswap64(cipher_block)), out);
+
+        uint64_t previous = 0;
+        if (target.mode == MODE_CBC) {
+            memcpy(&previous, (first + b == 0) ? target.iv : cipher + (first + b - 1) * 8, 8);
+        }
+        for (int lane = 0; lane < LANES; lane++) {
+            uint64_t plain = __builtin_bswap64(out[lane]) ^ previous;
+            memcpy(decrypted_text[lane] + b * 8, &plain, 8);
+        }
+    }
+
+    unsigned hits = 0;
+    for (int lane = 0; lane < LANES; lane++) {
+        bool match;
+        if (target.crib_offset >= 0) {
+            match = memcmp(decrypted_text[lane] + (target.crib_offset - first * 8), phrase.data(), phrase.size()) == 0;
+        } else {
+            match = memmem(decrypted_text[lane], blocks * 8, phrase.data(), phrase.size()) != nullptr;
+        }
+
+        DES_key_schedule schedule;
+        if (match && makeKeySchedule(keys[lane], schedule)) {
+            hits |= 1u << lane;
+        }
+    }
+    return hits;
+}
+
+// Una sola llave con el DES propio (restos de los rangos y recorridos de a una llave)
+bool tryKeyDes(uint64_t key_num, const SearchTarget& target) {
+    return tryKeysDes<1>(&key_num, target) != 0;
+}
+
+/*
+Función encryptKnownBlock
+Parámetros:
+    schedule: DES_key_schedule, clave ya preparada
+    block: uint64_t, bloque de entrada (big-endian)
+Retorno:
+    uint64_t, bloque cifrado con DES (big-endian)
+*/
+uint64_t encryptKnownBlock(DES_key_schedule& schedule, uint64_t block) {
+    DES_cblock in, out;
+    for (int i = 0; i < 8; i++) {
+        in[i] = (block >> (56 - 8 * i)) & 0xFF;
+    }
+    DES_ecb_encrypt(&in, &out, &schedule, DES_ENCRYPT);
+    uint64_t result = 0;
+    for (int i = 0; i < 8; i++) {
+        result = (result << 8) | out[i];
+    }
+    return result;
+}
+
+/*
+Función tryKeyTargets
+Parámetros:
+    key_num: uint64_t, clave numérica de 64 bits
+    target: SearchTarget, objetivo en modo de varios objetivos
+Descripción:
+    Cifra el bloque conocido una sola vez con la llave y lo busca en el conjunto de bloques de
+    todos los objetivos: el costo por llave no depende de la cantidad de objetivos.
+Retorno:
+    bool, true si la llave resuelve al menos un objetivo
+*/
+bool tryKeyTargets(uint64_t key_num, const SearchTarget& target) {
+    DES_key_schedule schedule;
+    if (!makeKeySchedule(key_num, schedule)) {
+        return false;
+    }
+    return target.target_set.contains(encryptKnownBlock(schedule, target.known_block));
+}
+
+// Variante de tryKeyTargets sobre el DES propio, LANES llaves a la vez
+template <int LANES>
+unsigned tryKeysTargetsDes(const uint64_t* keys, const SearchTarget& target) {
+    DesSubkeys subkeys[LANES];
+    desSubkeys<LANES>(keys, subkeys);
+    uint64_t out[LANES];
+    desEncryptLanes<LANES>(subkeys, desInitialPermutation(target.known_block), out);
+
+    unsigned hits = 0;
+    for (int lane = 0; lane < LANES; lane++) {
+        DES_key_schedule schedule;
+        if (target.target_set.contains(out[lane]) && makeKeySchedule(keys[lane], schedule)) {
+            hits |= 1u << lane;
+        }
+    }
+    return hits;
+}
+
+bool tryKeyTargetsDes(uint64_t key_num, const SearchTarget& target) {
+    return tryKeysTargetsDes<1>(&key_num, target) != 0;
+}
+
+/*
+Función fixedKernelRow
+Descripción:
+    Tabla de kernels especializados para una cantidad de bloques, indexada por largo de frase - 1.
+*/
+template <bool CBC, size_t BLOCKS, size_t... LENGTHS>
+KeyTestKernel fixedKernelRow(size_t crib_len, index_sequence<LENGTHS...>) {
+    static const KeyTestKernel row[] = { &tryKeyFixed<CBC, BLOCKS, LENGTHS + 1>... };
+    return row[crib_len - 1];
+}
+
+/*
+Función selectFixedKernel
+Parámetros:
+    blocks: size_t, cantidad de bloques a verificar
+    crib_len: size_t, largo de la frase clave (1 a max_fixed_crib)
+Retorno:
+    KeyTestKernel, kernel especializado o nullptr si no hay uno para esa forma
+*/
+template <bool CBC>
+KeyTestKernel selectFixedKernel(size_t blocks, size_t crib_len) {
+    auto lengths = make_index_sequence<max_fixed_crib>{};
+    switch (blocks) {
+        case 1: return fixedKernelRow<CBC, 1>(crib_len, lengths);
+        case 2: return fixedKernelRow<CBC, 2>(crib_len, lengths);
+        case 3: return fixedKernelRow<CBC, 3>(crib_len, lengths);
+        case 4: return fixedKernelRow<CBC, 4>(crib_len, lengths);
+        case 8: return fixedKernelRow<CBC, 8>(crib_len, lengths);
+        default: return nullptr;
+    }
+}
+
+enum DesBackend { DES_OPENSSL = 0, DES_INTERLEAVED = 1 };
+
+KeyBatchKernel batch_kernel = nullptr;  // Kernel por lotes elegido para la búsqueda, nullptr si no hay
+
+/*
+Función selectKernel
+Parámetros:
+    target: SearchTarget, objetivo de la búsqueda
+    backend: int, implementación de DES preferida (DesBackend)
+    batch: KeyBatchKernel, kernel por lotes para el mismo objetivo (salida, nullptr si no hay)
+    description: string, descripción del kernel elegido (salida)
+Descripción:
+    Elige al preparar el trabajo el kernel que corresponde a la forma del objetivo. En modo de
+    varios objetivos se usa tryKeyTargets (o su variante por lotes). Con el
+    DES propio (por omisión), los objetivos ECB/CBC de hasta max_interleaved_blocks bloques
+    verificados usan tryKeysDes con des_lanes llaves a la vez, si la implementación coincide
+    con OpenSSL (desSelfTest). Con OpenSSL, las formas ECB/CBC de 1, 2, 3, 4 u 8 bloques y
+    frase de hasta 16 bytes usan el kernel especializado. Cualquier otra forma usa tryKey.
+Retorno:
+    KeyTestKernel, kernel de una llave a usar en la búsqueda
+*/
+KeyTestKernel selectKernel(const SearchTarget& target, int backend, KeyBatchKernel& batch, string& description) {
+    size_t first;
+    size_t blocks = checkedBlocks(target, first);
+    size_t crib_len = target.key_phrase.size();
+    bool block_mode = target.mode == MODE_ECB || target.mode == MODE_CBC;
+    const char* mode_name = (target.mode == MODE_CBC) ? "CBC" : "ECB";
+    batch = nullptr;
+
+    if (target.multiTarget()) {
+        description = "varios objetivos (" + to_string(target.target_blocks.size()) + " bloques" +
+                      (target.target_set.usesBloom() ? ", filtro de Bloom" : "") + ", ";
+        if (backend == DES_INTERLEAVED && desSelfTest()) {
+            batch = tryKeysTargetsDes<des_lanes>;
+            description += "DES propio)";
+            return tryKeyTargetsDes;
+        }
+        description += "OpenSSL)";
+        return tryKeyTargets;
+    }
+
+    if (backend == DES_INTERLEAVED && block_mode && crib_len >= 1 && crib_len <= blocks * 8 && blocks <= max_interleaved_blocks) {
+        if (desSelfTest()) {
+            batch = tryKeysDes<des_lanes>;
+            description = string("DES propio (") + mode_name + ", " + to_string(blocks) + " bloques, " + to_string(des_lanes) +
+                          " llaves intercaladas)";
+            return tryKeyDes;
+        }
+        cerr << "El DES propio no coincide con OpenSSL; se usa OpenSSL" << endl;
+    }
+
+    KeyTestKernel kernel = nullptr;
+    if (block_mode && crib_len >= 1 && crib_len <= max_fixed_crib && crib_len <= blocks * 8) {
+        kernel = (target.mode == MODE_CBC) ? selectFixedKernel<true>(blocks, crib_len) : selectFixedKernel<false>(blocks, crib_len);
+    }
+
+    if (kernel == nullptr) {
+        description = "genérico";
+        return tryKey;
+    }
+
+    description = string("especializado (") + mode_name + ", " + to_string(blocks) +
+                  " bloques, frase de " + to_string(crib_len) + " bytes)";
+    return kernel;
+}
+
+/*
+Función testKeys
+Parámetros:
+    first: uint64_t, índice de la primera llave
+    count: unsigned, llaves consecutivas a probar (1 a des_lanes)
+    kernel: KeyTestKernel, kernel de una llave
+    target: SearchTarget, objetivo de la búsqueda
+    keys: uint64_t[des_lanes], llaves probadas (salida)
+Descripción:
+    Convierte los índices en llaves y las prueba con el kernel por lotes si hay uno y el
+    lote está completo, o una por una.
+Retorno:
+    unsigned, máscara de las llaves que pasan el kernel
+*/
+inline unsigned testKeys(uint64_t first, unsigned count, KeyTestKernel kernel, const SearchTarget& target, uint64_t* keys) {
+    for (unsigned lane = 0; lane < count; lane++) {
+        keys[lane] = target.space.key(first + lane);
+    }
+    if (batch_kernel && count == des_lanes) {
+        return batch_kernel(keys, target);
+    }
+    unsigned hits = 0;
+    for (unsigned lane = 0; lane < count; lane++) {
+        if (kernel(keys[lane], target)) {
+            hits |= 1u << lane;
+        }
+    }
+    return hits;
+}
+
+// Evento de la traza en el formato de Chrome/Perfetto ("X" = intervalo, "i" = instantáneo)
+struct TraceEvent {
+    const char* name;
+    char phase;
+    double start;
+    double duration;
+    uint64_t arg;
+};
+
+// Búfer circular de eventos de un hilo; al llenarse se sobrescriben los más antiguos
+struct TraceBuffer {
+    vector<TraceEvent> events;
+    size_t next = 0;
+    bool wrapped = false;
+    int thread_id = 0;
+    int rank = 0;
+};
+
+const size_t trace_capacity = 1 << 16;  // Eventos por hilo
+
+bool trace_enabled = false;
+mutex trace_mutex;
+vector<TraceBuffer*> trace_buffers;
+thread_local TraceBuffer* trace_buffer = nullptr;
+thread_local Transport* trace_transport = nullptr;  // Reloj y rango del hilo que registra
+
+/*
+Función traceEvent
+Parámetros:
+    name: nombre del evento (cadena literal)
+    phase: 'X' para intervalos, 'i' para eventos instantáneos
+    start: inicio según el reloj del transporte
+    duration: duración en segundos (0 para instantáneos)
+    arg: valor asociado (unidad de trabajo, proceso, etc.)
+Descripción:
+    Registra un evento en el búfer del hilo que llama. No hace nada si la traza está desactivada.
+*/
+inline void traceEvent(const char* name, char phase, double start, double duration, uint64_t arg) {
+    if (!trace_enabled) {
+        return;
+    }
+
+    if (trace_buffer == nullptr) {
+        lock_guard<mutex> lock(trace_mutex);
+        trace_buffer = new TraceBuffer();
+        trace_buffer->events.resize(trace_capacity);
+        trace_buffer->thread_id = trace_buffers.size();
+        trace_buffer->rank = trace_transport->rank();
+        trace_buffers.push_back(trace_buffer);
+    }
+
+    trace_buffer->events[trace_buffer->next] = {name, phase, start, duration, arg};
+    if (++trace_buffer->next == trace_capacity) {
+        trace_buffer->next = 0;
+        trace_buffer->wrapped = true;
+    }
+}
+
+inline void traceSpan(const char* name, double start, uint64_t arg) {
+    if (trace_enabled) {
+        traceEvent(name, 'X', start, trace_transport->time() - start, arg);
+    }
+}
+
+inline void traceInstant(const char* name, uint64_t arg) {
+    if (trace_enabled) {
+        traceEvent(name, 'i', trace_transport->time(), 0, arg);
+    }
+}
+
+/*
+Función writeTrace
+Parámetros:
+    prefix: prefijo del archivo de salida
+    rank: rango del proceso (un track por proceso)
+    role: "maestro" o "esclavo"
+    origin: instante común de inicio de la traza
+Descripción:
+    Escribe los eventos de todos los hilos del rango en <prefix>.<rank>.json, en el formato
+    de arreglo JSON que abren chrome://tracing y Perfetto. Los archivos de todos los procesos
+    se pueden unir con: jq -s add <prefix>.*.json > traza.json
+*/
+void writeTrace(const string& prefix, int rank, const string& role, double origin) {
+    string filename = prefix + "." + to_string(rank) + ".json";
+    ofstream file(filename);
+    if (!file.is_open()) {
+        cerr << "No se pudo crear el archivo " << filename << endl;
+        return;
+    }
+
+    file << "[{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank
+         << ",\"args\":{\"name\":\"Proceso " << rank << " (" << role << ")\"}}";
+
+    lock_guard<mutex> lock(trace_mutex);
+    file << fixed << setprecision(3);
+    for (TraceBuffer* buffer : trace_buffers) {
+        if (buffer->rank != rank) {
+            continue;
+        }
+        size_t count = buffer->wrapped ? trace_capacity : buffer->next;
+        size_t first = buffer->wrapped ? buffer->next : 0;
+
+        for (size_t j = 0; j < count; j++) {
+            const TraceEvent& event = buffer->events[(first + j) % trace_capacity];
+            file << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"" << event.phase << "\",\"pid\":" << rank
+                 << ",\"tid\":" << buffer->thread_id << ",\"ts\":" << (event.start - origin) * 1e6;
+            if (event.phase == 'X') {
+                file << ",\"dur\":" << event.duration * 1e6;
+            } else {
+                file << ",\"s\":\"t\"";
+            }
+            file << ",\"args\":{\"valor\":" << event.arg << "}}";
+        }
+    }
+    file << "]\n";
+}
+
+// Contadores de hardware medidos alrededor del kernel (perf_event_open)
+enum PerfEvent { PERF_CYCLES = 0, PERF_INSTRUCTIONS = 1, PERF_CACHE_MISSES = 2, PERF_BRANCH_MISSES = 3, PERF_EVENTS = 4 };
+
+// Totales de un hilo en las regiones de búsqueda
+struct PerfTotals {
+    uint64_t values[PERF_EVENTS] = {0, 0, 0, 0};
+    uint64_t keys = 0;      // Llaves probadas dentro de las regiones medidas
+    double seconds = 0;     // Tiempo dentro de las regiones medidas
+};
+
+/*
+Clase PerfCounters
+Descripción:
+    Grupo de contadores del hilo que lo abre (ciclos, instrucciones, fallos de caché y fallos
+    de predicción de saltos), solo en modo usuario. Se habilitan al entrar a una región de
+    búsqueda (un rango de llaves) y se deshabilitan al salir, de modo que la calibración, los
+    mensajes y las esperas no se cuentan. Si el núcleo no permite abrirlos (perf_event_paranoid,
+    contenedores, máquinas virtuales sin PMU) solo se mide el tiempo y las llaves.
+*/
+class PerfCounters {
+public:
+    PerfCounters() {
+        const uint64_t configs[PERF_EVENTS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                               PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        for (int e = 0; e < PERF_EVENTS; e++) {
+            perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[e];
+            attr.disabled = (e == 0);  // El líder del grupo controla a todos
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+
+            fds_[e] = syscall(SYS_perf_event_open, &attr, 0, -1, e == 0 ? -1 : fds_[0], 0);
+            if (fds_[e] < 0) {
+                error_ = strerror(errno);
+                close();
+                return;
+            }
+        }
+    }
+
+    ~PerfCounters() { close(); }
+
+    bool available() const { return fds_[0] >= 0; }
+    const string& error() const { return error_; }
+    const PerfTotals& totals() const { return totals_; }
+
+    void start(double now) {
+        region_start_ = now;
+        if (available()) {
+            read(region_values_);
+            ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+    }
+
+    void stop(double now, uint64_t keys) {
+        if (available()) {
+            ioctl(fds_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+            uint64_t values[PERF_EVENTS];
+            read(values);
+            for (int e = 0; e < PERF_EVENTS; e++) {
+                totals_.values[e] += values[e] - region_values_[e];
+            }
+        }
+        totals_.keys += keys;
+        totals_.seconds += now - region_start_;
+    }
+
+private:
+    // Lee los valores acumulados de todo el grupo
+    void read(uint64_t* values) {
+        uint64_t buffer[1 + PERF_EVENTS];
+        if (::read(fds_[0], buffer, sizeof(buffer)) == (ssize_t)sizeof(buffer)) {
+            memcpy(values, buffer + 1, sizeof(uint64_t) * PERF_EVENTS);
+        } else {
+            memset(values, 0, sizeof(uint64_t) * PERF_EVENTS);
+        }
+    }
+
+    void close() {
+        for (int e = 0; e < PERF_EVENTS; e++) {
+            if (fds_[e] >= 0) {
+                ::close(fds_[e]);
+                fds_[e] = -1;
+            }
+        }
+    }
+
+    int fds_[PERF_EVENTS] = {-1, -1, -1, -1};
+    uint64_t region_values_[PERF_EVENTS] = {0, 0, 0, 0};
+    double region_start_ = 0;
+    PerfTotals totals_;
+    string error_;
+};
+
+bool perf_enabled = false;
+thread_local PerfCounters* perf_counters = nullptr;  // Contadores del hilo, nullptr si están desactivados
+
+// Marca el inicio y el fin de una región de búsqueda (no hace nada si -p no se indicó)
+inline void perfStart() {
+    if (perf_counters) {
+        perf_counters->start(trace_transport->time());
+    }
+}
+
+inline void perfStop(uint64_t keys) {
+    if (perf_counters) {
+        perf_counters->stop(trace_transport->time(), keys);
+    }
+}
+
+/*
+Función reportPerf
+Parámetros:
+    rank: int, rango que reporta
+    counters: PerfCounters, contadores del hilo
+Descripción:
+    Imprime en una sola línea las llaves/s dentro del kernel, el IPC y los fallos de caché y de
+    predicción de saltos por llave del hilo.
+*/
+void reportPerf(int rank, const PerfCounters& counters) {
+    const PerfTotals& totals = counters.totals();
+    ostringstream line;
+    line << "Contadores proceso " << rank << " (hilo " << syscall(SYS_gettid) << "): " << totals.keys << " llaves";
+
+    if (totals.seconds > 0) {
+        line << ", " << fixed << setprecision(0) << totals.keys / totals.seconds << " llaves/s";
+    }
+
+    if (!counters.available()) {
+        line << ", contadores de hardware no disponibles (" << counters.error() << ")";
+    } else if (totals.keys > 0) {
+        double keys = totals.keys;
+        line << setprecision(2)
+             << ", IPC " << (totals.values[PERF_CYCLES] ? (double)totals.values[PERF_INSTRUCTIONS] / totals.values[PERF_CYCLES] : 0)
+             << ", ciclos/llave " << setprecision(0) << totals.values[PERF_CYCLES] / keys
+             << ", instrucciones/llave " << totals.values[PERF_INSTRUCTIONS] / keys
+             << setprecision(4)
+             << ", fallos de caché/llave " << totals.values[PERF_CACHE_MISSES] / keys
+             << ", fallos de salto/llave " << totals.values[PERF_BRANCH_MISSES] / keys;
+    }
+
+    line << "\n";
+    cout << line.str() << flush;
+}
+
+/*
+Función loadText
+Parámetros:
+    filename: string, nombre del archivo a cargar
+Descripción:
+    Carga el contenido de un archivo de texto en un string.
+Retorno:
+    string, contenido del archivo
+*/
+string loadText(const string& filename) {
+    ifstream file(filename);
+
+    if (!file.is_open()) {
+        cerr << "No se pudo abrir el archivo " << filename << endl;
+        return "";
+    }
+
+    string text((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    file.close();
+
+    return text;
+}
+
+/*
+Función loadTargets
+Parámetros:
+    filename: string, archivo con un bloque cifrado por línea (16 dígitos hexadecimales)
+    plain_text: string, texto plano conocido (se usa su primer bloque, con relleno de ceros)
+    target: SearchTarget, recibe known_block y target_blocks según el modo y el IV
+Descripción:
+    Prepara el modo de varios objetivos a partir del primer bloque P del texto conocido, el IV
+    y el primer bloque cifrado C de cada objetivo: en ECB se cifra P y se busca C, en CBC se
+    cifra P ^ IV y se busca C, y en CFB y OFB se cifra el IV y se busca C ^ P.
+Retorno:
+    bool, false si el archivo no se puede abrir, está vacío o tiene una línea inválida
+*/
+bool loadTargets(const string& filename, const string& plain_text, SearchTarget& target) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        cerr << "No se pudo abrir el archivo " << filename << endl;
+        return false;
+    }
+
+    uint64_t plain = 0, iv = 0;
+    for (int i = 0; i < 8; i++) {
+        plain = (plain << 8) | (i < (int)plain_text.size() ? (unsigned char)plain_text[i] : 0);
+        iv = (iv << 8) | target.iv[i];
+    }
+    bool stream_mode = target.mode == MODE_CFB || target.mode == MODE_OFB;
+    target.known_block = stream_mode ? iv : (target.mode == MODE_CBC ? plain ^ iv : plain);
+
+    string line;
+    int line_number = 0;
+    while (getline(file, line)) {
+        line_number++;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+        if (line.size() != 16 || line.find_first_not_of("0123456789abcdefABCDEF") != string::npos) {
+            cerr << "Línea " << line_number << " de " << filename << ": se esperaba un bloque de 16 dígitos hexadecimales" << endl;
+            return false;
+        }
+        uint64_t cipher = stoull(line, nullptr, 16);
+        target.target_blocks.push_back(stream_mode ? cipher ^ plain : cipher);
+    }
+
+    if (target.target_blocks.empty()) {
+        cerr << "El archivo " << filename << " no tiene objetivos" << endl;
+        return false;
+    }
+    return true;
+}
+
+/*
+Función parseCpuList
+Parámetros:
+    list: string, lista de CPUs en formato de Linux (por ejemplo "0-3,8-11")
+Retorno:
+    vector<int>, CPUs de la lista
+*/
+vector<int> parseCpuList(const string& list) {
+    vector<int> cpus;
+    stringstream stream(list);
+    string range;
+
+    while (getline(stream, range, ',')) {
+        if (range.empty()) {
+            continue;
+        }
+        size_t dash = range.find('-');
+        int first = stoi(range.substr(0, dash));
+        int last = (dash == string::npos) ? first : stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+
+    return cpus;
+}
+
+/*
+Función detectNumaNodes
+Descripción:
+    Lee la topología NUMA desde /sys/devices/system/node. Si no está disponible,
+    devuelve un único nodo con las CPUs en las que el proceso puede ejecutarse.
+Retorno:
+    vector<vector<int>>, CPUs de cada nodo NUMA
+*/
+vector<vector<int>> detectNumaNodes() {
+    vector<vector<int>> nodes;
+
+    for (int node = 0;; node++) {
+        ifstream file("/sys/devices/system/node/node" + to_string(node) + "/cpulist");
+        if (!file.is_open()) {
+            break;
+        }
+        string list;
+        getline(file, list);
+        vector<int> cpus = parseCpuList(list);
+        if (!cpus.empty()) {
+            nodes.push_back(cpus);
+        }
+    }
+
+    if (nodes.empty()) {
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        sched_getaffinity(0, sizeof(mask), &mask);
+        vector<int> cpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &mask)) {
+                cpus.push_back(cpu);
+            }
+        }
+        nodes.push_back(cpus);
+    }
+
+    return nodes;
+}
+
+thread_local int pinned_cpu = -1;   // Núcleo al que pinToCore fijó el hilo, -1 si no se fijó
+thread_local int pinned_node = -1;  // Nodo NUMA de ese núcleo
+
+/*
+Función pinToCore
+Parámetros:
+    local_index: int, índice del proceso (o hilo) dentro del nodo físico
+    numa_node: int, nodo NUMA asignado (salida)
+Descripción:
+    Reparte los procesos de un mismo nodo físico entre los nodos NUMA en forma cíclica y
+    fija el hilo que llama a un núcleo de su nodo, que desde entonces usa las tablas de DES
+    de ese nodo. Si el lanzador ya restringió la afinidad (por ejemplo mpirun --bind-to core)
+    se respeta y no se cambia.
+Retorno:
+    int, núcleo asignado o -1 si no se fijó
+*/
+int pinToCore(int local_index, int& numa_node) {
+    cpu_set_t current;
+    CPU_ZERO(&current);
+    sched_getaffinity(0, sizeof(current), &current);
+
+    numa_node = -1;
+    if (CPU_COUNT(&current) < sysconf(_SC_NPROCESSORS_ONLN)) {
+        return -1;
+    }
+
+    vector<vector<int>> nodes = detectNumaNodes();
+    numa_node = local_index % nodes.size();
+    const vector<int>& cpus = nodes[numa_node];
+    int cpu = cpus[(local_index / nodes.size()) % cpus.size()];
+
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(cpu, &mask);
+    if (sched_setaffinity(0, sizeof(mask), &mask) != 0) {
+        return -1;
+    }
+
+    pinned_cpu = cpu;
+    pinned_node = numa_node;
+    desUseNodeTables(numa_node);
+    return cpu;
+}
+
+/*
+Función spreadHelperThread
+Parámetros:
+    cpu, numa_node: int, núcleo y nodo del hilo de búsqueda que creó al auxiliar (-1 si no se fijó)
+Descripción:
+    Un hilo hereda la afinidad de quien lo crea, así que un auxiliar de un hilo fijado
+    competiría por su único núcleo. Lo extiende a los demás núcleos del nodo NUMA, cerca
+    de los datos del hilo de búsqueda; si el nodo no tiene otros, usa el nodo completo.
+*/
+void spreadHelperThread(int cpu, int numa_node) {
+    if (cpu < 0 || numa_node < 0) {
+        return;
+    }
+    vector<vector<int>> nodes = detectNumaNodes();
+    if (numa_node >= (int)nodes.size()) {
+        return;
+    }
+
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (int other : nodes[numa_node]) {
+        if (other != cpu) {
+            CPU_SET(other, &mask);
+        }
+    }
+    if (CPU_COUNT(&mask) == 0) {
+        CPU_SET(cpu, &mask);
+    }
+    sched_setaffinity(0, sizeof(mask), &mask);
+}
+
+// Estrategias de reparto del espacio de llaves
+enum Strategy { STRATEGY_BLOCKS = 0, STRATEGY_INTERLEAVED = 1, STRATEGY_MASTER = 2, STRATEGY_DFS = 3, STRATEGY_COUNTER = 4 };
+
+const char* strategy_names[] = {"bloques", "intercalado", "maestro", "dfs", "rma"};
+
+/*
+Función parseStrategy
+Parámetros:
+    name: string, nombre de la estrategia (bloques, intercalado, maestro, dfs, rma)
+Retorno:
+    int, estrategia correspondiente o -1 si no es válida
+*/
+int parseStrategy(const string& name) {
+    for (int s = 0; s < 5; s++) {
+        if (name == strategy_names[s]) {
+            return s;
+        }
+    }
+    return -1;
+}
+
+const double min_printable_ratio = 0.95;  // Fracción mínima de bytes de texto en un candidato aceptado
+const size_t max_pending_candidates = 4096;  // Candidatos en cola antes de frenar la búsqueda
+
+/*
+Función verifyCandidate
+Parámetros:
+    key: uint64_t, llave que pasó la prueba rápida del kernel
+    target: SearchTarget, objetivo de la búsqueda
+    plain: string&, texto descifrado (salida, sin el relleno)
+    reason: string&, motivo del rechazo (salida)
+Descripción:
+    Verificación completa de un candidato, de la etapa más barata a la más cara: relleno del
+    último bloque, descifrado completo, frase clave en su posición y frases adicionales (-c).
+    Las etapas que juzgan el contenido solo se aplican si el objetivo declara que el texto
+    plano es texto (-texto): relleno estricto (ceros al final y ninguno antes, como lo deja
+    encryptText) y fracción de bytes de texto (ASCII imprimible, espacios o secuencias UTF-8
+    válidas). Sin -texto un texto plano binario no se puede juzgar y se acepta por las frases.
+Retorno:
+    bool, true si el candidato pasa todas las etapas
+*/
+bool verifyCandidate(uint64_t key, const SearchTarget& target, string& plain, string& reason) {
+    DES_key_schedule schedule;
+    size_t blocks = target.cipher_text.size() / 8;
+    if (blocks == 0 || !makeKeySchedule(key, schedule)) {
+        reason = "llave débil";
+        return false;
+    }
+
+    // Etapa 1: relleno, descifrando solo el último bloque
+    unsigned char tail[8];
+    decryptBlocks(schedule, target, blocks - 1, blocks - 1, tail);
+    int padding = 0;
+    while (padding < 8 && tail[7 - padding] == 0) {
+        padding++;
+    }
+    if (!target.text_plain) {
+        padding = min(padding, 7);  // Los ceros finales pueden ser datos; se recorta a lo sumo el relleno
+    } else if (padding == 8 || memchr(tail, 0, 8 - padding) != nullptr) {
+        reason = "relleno inválido";
+        return false;
+    }
+
+    // Etapa 2: texto completo y frases
+    plain.assign(blocks * 8, '\0');
+    decryptBlocks(schedule, target, 0, blocks - 1, (unsigned char*)&plain[0]);
+    plain.resize(plain.size() - padding);
+    if (target.text_plain && plain.find('\0') != string::npos) {
+        reason = "relleno inválido";
+        return false;
+    }
+
+    bool crib = (target.crib_offset >= 0) ? plain.compare(target.crib_offset, target.key_phrase.size(), target.key_phrase) == 0
+                                          : plain.find(target.key_phrase) != string::npos;
+    if (!crib) {
+        reason = "frase clave ausente";
+        return false;
+    }
+    for (const string& phrase : target.extra_phrases) {
+        if (plain.find(phrase) == string::npos) {
+            reason = "falta la frase \"" + phrase + "\"";
+            return false;
+        }
+    }
+
+    // Etapa 3: puntuación del texto plano
+    if (!target.text_plain) {
+        return true;
+    }
+    size_t text_bytes = 0;
+    for (size_t i = 0; i < plain.size();) {
+        unsigned char c = plain[i];
+        size_t length = (c >= 0xC2 && c <= 0xDF) ? 2 : (c >= 0xE0 && c <= 0xEF) ? 3 : (c >= 0xF0 && c <= 0xF4) ? 4 : 1;
+        bool sequence = length > 1 && i + length <= plain.size();
+        for (size_t j = 1; j < length && sequence; j++) {
+            sequence = ((unsigned char)plain[i + j] & 0xC0) == 0x80;
+        }
+        if (sequence) {
+            text_bytes += length;  // Carácter UTF-8 completo
+            i += length;
+        } else {
+            if ((c >= 0x20 && c < 0x7F) || c == '\n' || c == '\r' || c == '\t') {
+                text_bytes++;
+            }
+            i++;
+        }
+    }
+    if (text_bytes < min_printable_ratio * plain.size()) {
+        reason = "no parece texto (" + to_string(100 * text_bytes / plain.size()) + "% imprimible)";
+        return false;
+    }
+
+    return true;
+}
+
+/*
+Clase CandidateVerifier
+Descripción:
+    Verificador de candidatos de un rango. Las llaves que pasan el kernel se encolan (submit)
+    y un hilo aparte las revisa con verifyCandidate, fuera del ciclo de búsqueda, que sigue
+    probando llaves. Los falsos positivos se descartan sin detener a nadie; el hilo de
+    búsqueda consulta confirmed() al sondear y solo entonces avisa a los demás rangos. Si la
+    cola se llena, submit espera para no acumular candidatos sin límite. El hilo verificador
+    no hereda el núcleo fijo del hilo de búsqueda (spreadHelperThread).
+*/
+class CandidateVerifier {
+public:
+    CandidateVerifier(const SearchTarget& target, int rank)
+        : target_(target), rank_(rank), worker_([this, cpu = pinned_cpu, node = pinned_node] {
+              spreadHelperThread(cpu, node);
+              run();
+          }) {}
+
+    ~CandidateVerifier() {
+        {
+            lock_guard<mutex> lock(mutex_);
+            closing_ = true;
+            pending_.clear();  // Los candidatos restantes ya no importan
+        }
+        work_cv_.notify_all();
+        worker_.join();
+    }
+
+    // Encola una llave que pasó la prueba rápida
+    void submit(uint64_t key) {
+        unique_lock<mutex> lock(mutex_);
+        idle_cv_.wait(lock, [this] { return pending_.size() < max_pending_candidates; });
+        pending_.push_back(key);
+        work_cv_.notify_one();
+    }
+
+    // Lectura barata desde el ciclo de búsqueda
+    bool confirmed() const { return confirmed_.load(memory_order_acquire); }
+
+    // Llave confirmada, válida cuando confirmed() es true
+    uint64_t key() const { return key_; }
+
+    // Espera a que se revisen todos los candidatos encolados
+    bool drain() {
+        unique_lock<mutex> lock(mutex_);
+        idle_cv_.wait(lock, [this] { return confirmed() || (pending_.empty() && !busy_); });
+        return confirmed();
+    }
+
+private:
+    void run() {
+        unique_lock<mutex> lock(mutex_);
+        while (true) {
+            work_cv_.wait(lock, [this] { return closing_ || !pending_.empty(); });
+            if (closing_) {
+                return;
+            }
+            uint64_t key = pending_.front();
+            pending_.pop_front();
+            busy_ = true;
+            lock.unlock();
+
+            string plain, reason;
+            bool accepted = !confirmed() && verifyCandidate(key, target_, plain, reason);
+            if (accepted) {
+                cout << "Texto descifrado con la llave: " << key << " -> " << plain << "\n";
+                key_ = key;
+                confirmed_.store(true, memory_order_release);
+            } else if (!confirmed()) {
+                cout << "Proceso " << rank_ << ": candidato " << key << " descartado (" << reason << ")" << endl;
+            }
+
+            lock.lock();
+            busy_ = false;
+            idle_cv_.notify_all();
+        }
+    }
+
+    const SearchTarget& target_;
+    int rank_;
+    mutex mutex_;
+    condition_variable work_cv_;  // Hay candidatos o se cierra el verificador
+    condition_variable idle_cv_;  // Se liberó espacio en la cola o terminó una verificación
+    deque<uint64_t> pending_;
+    bool busy_ = false;
+    bool closing_ = false;
+    uint64_t key_ = 0;
+    atomic<bool> confirmed_{false};
+    thread worker_;  // Último miembro: arranca con los demás ya construidos
+};
+
+const size_t key_buffer_size = 1 << 16;  // Llaves por búfer de escritura del modo exhaustivo
+const int key_buffer_count = 4;          // Búferes por rango (memoria acotada: 2 MB)
+
+/*
+Clase KeyWriter
+Descripción:
+    Salida del modo exhaustivo (-todas): cada rango escribe todas las llaves que pasan el
+    kernel en <prefijo>.<rango>.bin, como uint64 en el orden de bytes de la máquina. El ciclo
+    de búsqueda solo copia la llave a un búfer; al llenarse, el búfer pasa a un hilo escritor
+    y la búsqueda sigue con otro búfer libre. La memoria queda acotada a key_buffer_count
+    búferes: si el disco no alcanza el ritmo, add espera a que se libere uno. Como el
+    verificador, el hilo escritor no comparte el núcleo fijo del hilo de búsqueda.
+*/
+class KeyWriter {
+public:
+    explicit KeyWriter(const string& filename) : filename_(filename), file_(fopen(filename.c_str(), "wb")) {
+        for (int b = 0; b < key_buffer_count; b++) {
+            buffers_[b].resize(key_buffer_size);
+            if (b != current_) {
+                free_.push_back(b);
+            }
+        }
+        worker_ = thread([this, cpu = pinned_cpu, node = pinned_node] {
+            spreadHelperThread(cpu, node);
+            run();
+        });
+    }
+
+    ~KeyWriter() {
+        close();
+    }
+
+    bool ok() const { return file_ != nullptr && !failed_; }
+    const string& filename() const { return filename_; }
+
+    // Agrega una llave desde el ciclo de búsqueda
+    inline void add(uint64_t key) {
+        buffers_[current_][count_++] = key;
+        if (count_ == key_buffer_size) {
+            submit();
+        }
+    }
+
+    // Escribe lo pendiente y cierra el archivo; retorna las llaves escritas
+    uint64_t close() {
+        if (worker_.joinable()) {
+            submit();
+            {
+                lock_guard<mutex> lock(mutex_);
+                closing_ = true;
+            }
+            work_cv_.notify_one();
+            worker_.join();
+            if (file_ && fclose(file_) != 0) {
+                failed_ = true;
+            }
+        }
+        return total_;
+    }
+
+private:
+    // Entrega el búfer actual al escritor y toma uno libre
+    void submit() {
+        unique_lock<mutex> lock(mutex_);
+        if (count_ > 0) {
+            full_.push_back(make_pair(current_, count_));
+            total_ += count_;
+            work_cv_.notify_one();
+            free_cv_.wait(lock, [this] { return !free_.empty(); });
+            current_ = free_.back();
+            free_.pop_back();
+            count_ = 0;
+        }
+    }
+
+    void run() {
+        unique_lock<mutex> lock(mutex_);
+        while (true) {
+            work_cv_.wait(lock, [this] { return closing_ || !full_.empty(); });
+            if (full_.empty()) {
+                return;  // Cerrando y sin búferes pendientes
+            }
+            pair<int, size_t> buffer = full_.front();
+            full_.pop_front();
+            lock.unlock();
+
+            if (file_ && fwrite(buffers_[buffer.first].data(), sizeof(uint64_t), buffer.second, file_) != buffer.second) {
+                failed_ = true;
+            }
+
+            lock.lock();
+            free_.push_back(buffer.first);
+            free_cv_.notify_one();
+        }
+    }
+
+    string filename_;
+    FILE* file_;
+    vector<uint64_t> buffers_[key_buffer_count];
+    int current_ = 0;                 // Búfer que llena el ciclo de búsqueda
+    size_t count_ = 0;                // Llaves en el búfer actual
+    uint64_t total_ = 0;
+    mutex mutex_;
+    condition_variable work_cv_;      // Hay búferes llenos o se cierra el archivo
+    condition_variable free_cv_;      // Se liberó un búfer
+    deque<pair<int, size_t>> full_;   // Búferes llenos en orden de llenado
+    vector<int> free_;
+    bool closing_ = false;
+    atomic<bool> failed_{false};
+    thread worker_;
+};
+
+thread_local KeyWriter* key_writer = nullptr;  // Salida del modo exhaustivo del hilo, nullptr si está desactivado
+
+/*
+Clase TargetReporter
+Descripción:
+    Reporte del modo de varios objetivos: cuando una llave pasa el kernel se vuelve a cifrar el
+    bloque conocido (es raro) para saber qué objetivos resuelve, y cada objetivo se informa la
+    primera vez que este rango lo resuelve. La búsqueda continúa con los demás objetivos.
+*/
+class TargetReporter {
+public:
+    TargetReporter(const SearchTarget& target, int rank) : target_(target), rank_(rank), solved_(target.target_blocks.size(), false) {}
+
+    void hit(uint64_t key) {
+        DES_key_schedule schedule;
+        if (!makeKeySchedule(key, schedule)) {
+            return;
+        }
+        uint64_t block = encryptKnownBlock(schedule, target_.known_block);
+        for (int id = target_.target_set.find(block); id >= 0; id = target_.target_set.nextWithSameBlock(id)) {
+            if (!solved_[id]) {
+                solved_[id] = true;
+                solved_count_++;
+                cout << "Proceso " << rank_ << ": objetivo " << id + 1 << " resuelto con la llave " << key << endl;
+                traceInstant("objetivo", id);
+            }
+        }
+    }
+
+    uint64_t solved() const { return solved_count_; }
+
+private:
+    const SearchTarget& target_;
+    int rank_;
+    vector<bool> solved_;
+    uint64_t solved_count_ = 0;
+};
+
+thread_local TargetReporter* target_reporter = nullptr;  // Reporte de varios objetivos del hilo, nullptr si no aplica
+
+/*
+Función recordHit
+Parámetros:
+    key: uint64_t, llave que pasó el kernel
+Descripción:
+    Destino de las llaves en los modos que no se detienen en la primera: salida exhaustiva
+    (-todas) y reporte de varios objetivos (-objetivos).
+Retorno:
+    bool, false si ningún modo la tomó y la llave debe ir al verificador de candidatos
+*/
+inline bool recordHit(uint64_t key) {
+    if (key_writer) {
+        key_writer->add(key);
+    }
+    if (target_reporter) {
+        target_reporter->hit(key);
+    }
+    return key_writer || target_reporter;
+}
+
+/*
+Función mergeKeyFiles
+Parámetros:
+    prefix: string, prefijo de los archivos <prefix>.<rango>.bin
+    size: int, número de rangos
+Descripción:
+    Une los archivos de todos los rangos en <prefix>.bin, ordenado y sin duplicados. Cada
+    rango recorre sus índices en orden creciente y la conversión índice -> llave preserva el
+    orden, así que cada archivo es una secuencia de tramos ordenados (más de uno solo si el
+    maestro reasignó unidades). Los archivos se mapean en memoria y los tramos se mezclan
+    con un montículo, sin cargar las llaves en memoria.
+Retorno:
+    long long, llaves escritas o -1 si hubo un error
+*/
+long long mergeKeyFiles(const string& prefix, int size) {
+    struct Run {
+        const uint64_t* next;
+        const uint64_t* end;
+    };
+    auto later = [](const Run& a, const Run& b) { return *a.next > *b.next; };
+    priority_queue<Run, vector<Run>, decltype(later)> runs(later);
+    vector<pair<void*, size_t>> maps;
+    bool ok = true;
+
+    for (int proc = 0; proc < size && ok; proc++) {
+        string filename = prefix + "." + to_string(proc) + ".bin";
+        int fd = open(filename.c_str(), O_RDONLY);
+        struct stat info;
+        if (fd < 0 || fstat(fd, &info) != 0) {
+            cerr << "No se pudo abrir el archivo " << filename << endl;
+            ok = false;
+        } else if (info.st_size >= (off_t)sizeof(uint64_t)) {
+            void* map = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (map == MAP_FAILED) {
+                cerr << "No se pudo mapear el archivo " << filename << endl;
+                ok = false;
+            } else {
+                madvise(map, info.st_size, MADV_SEQUENTIAL);
+                maps.push_back(make_pair(map, info.st_size));
+                const uint64_t* keys = (const uint64_t*)map;
+                size_t count = info.st_size / sizeof(uint64_t);
+                size_t run_start = 0;
+                for (size_t i = 1; i <= count; i++) {
+                    if (i == count || keys[i] < keys[i - 1]) {
+                        runs.push({keys + run_start, keys + i});
+                        run_start = i;
+                    }
+                }
+            }
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    long long written = 0;
+    FILE* output = ok ? fopen((prefix + ".bin").c_str(), "wb") : nullptr;
+    if (ok && !output) {
+        cerr << "No se pudo crear el archivo " << prefix << ".bin" << endl;
+        ok = false;
+    }
+    if (ok) {
+        vector<uint64_t> buffer;
+        buffer.reserve(key_buffer_size);
+        uint64_t last = 0;
+        while (!runs.empty()) {
+            Run run = runs.top();
+            runs.pop();
+            uint64_t key = *run.next++;
+            if (written == 0 || key != last) {
+                // Las unidades repetidas por el maestro producen llaves duplicadas
+                buffer.push_back(key);
+                last = key;
+                written++;
+                if (buffer.size() == key_buffer_size) {
+                    ok = ok && fwrite(buffer.data(), sizeof(uint64_t), buffer.size(), output) == buffer.size();
+                    buffer.clear();
+                }
+            }
+            if (run.next != run.end) {
+                runs.push(run);
+            }
+        }
+        ok = ok && fwrite(buffer.data(), sizeof(uint64_t), buffer.size(), output) == buffer.size();
+        ok = (fclose(output) == 0) && ok;
+    }
+
+    for (auto& map : maps) {
+        munmap(map.first, map.second);
+    }
+    return ok ? written : -1;
+}
+
+// Resultado de una búsqueda, válido en el rango 0
+struct SearchResult {
+    bool found = false;
+    uint64_t key = 0;
+    int unresponsive_workers = 0;  // Esclavos que no confirmaron la señal de detener (maestro/esclavo)
+    int joined_workers = 0;        // Procesos que se unieron por el puerto (maestro/esclavo)
+};
+
+/*
+Estructura SearchProfile
+Descripción:
+    Parámetros de rendimiento de la búsqueda. Los valores por omisión son los de siempre; un
+    perfil generado con -autoajuste en cada tipo de nodo los reemplaza al iniciar. El DES y el
+    intervalo de sondeo son de cada proceso (según su nodo); el tamaño de las rondas y de las
+    unidades de trabajo los fija el rango 0 para todos, porque el reparto debe coincidir.
+*/
+struct SearchProfile {
+    int des_backend = DES_INTERLEAVED;     // des=propio|openssl
+    uint64_t stop_check_interval = 4096;   // sondeo=<llaves entre revisiones de detener> (potencia de 2)
+    uint64_t range_size = 50000000;        // rango=<llaves por proceso y ronda> (bloques)
+    uint64_t work_unit_size = 1000000;     // unidad=<llaves por unidad de trabajo> (maestro, rma)
+};
+
+SearchProfile search_profile;  // Perfil activo del proceso
+
+/*
+Función defaultProfileName
+Descripción:
+    Nombre del perfil del nodo actual: busqueda.<nombre del host>.perfil en el directorio de
+    trabajo, para que cada tipo de nodo cargue el suyo.
+Retorno:
+    string, nombre del archivo
+*/
+string defaultProfileName() {
+    char host[256] = "local";
+    gethostname(host, sizeof(host) - 1);
+    return string("busqueda.") + host + ".perfil";
+}
+
+/*
+Función loadProfile
+Parámetros:
+    filename: string, archivo de perfil (líneas clave=valor, # para comentarios)
+    profile: SearchProfile, perfil a completar; las claves ausentes conservan su valor
+Descripción:
+    Lee un perfil generado por -autoajuste. El intervalo de sondeo se redondea a la potencia
+    de 2 inferior.
+Retorno:
+    bool, true si el archivo existe y todos los valores son válidos
+*/
+bool loadProfile(const string& filename, SearchProfile& profile) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    map<string, string> fields;
+    string line;
+    while (getline(file, line)) {
+        size_t equals = line.find('=');
+        if (!line.empty() && line[0] != '#' && equals != string::npos) {
+            fields[line.substr(0, equals)] = line.substr(equals + 1);
+        }
+    }
+
+    SearchProfile loaded = profile;
+    try {
+        if (fields.count("des")) {
+            loaded.des_backend = (fields["des"] == "openssl") ? DES_OPENSSL : (fields["des"] == "propio") ? DES_INTERLEAVED : -1;
+        }
+        if (fields.count("sondeo")) loaded.stop_check_interval = stoull(fields["sondeo"]);
+        if (fields.count("rango")) loaded.range_size = stoull(fields["rango"]);
+        if (fields.count("unidad")) loaded.work_unit_size = stoull(fields["unidad"]);
+    } catch (const exception&) {
+        return false;
+    }
+    if (loaded.des_backend < 0 || loaded.stop_check_interval == 0 || loaded.range_size == 0 || loaded.work_unit_size == 0) {
+        return false;
+    }
+    loaded.stop_check_interval = 1ULL << (63 - __builtin_clzll(loaded.stop_check_interval));
+    profile = loaded;
+    return true;
+}
+
+/*
+Función saveProfile
+Parámetros:
+    filename: string, archivo de perfil
+    profile: SearchProfile, perfil a guardar
+    notes: string, comentarios con las mediciones (una línea por medición)
+Descripción:
+    Escribe el perfil en el formato que lee loadProfile.
+Retorno:
+    bool, true si se escribió
+*/
+bool saveProfile(const string& filename, const SearchProfile& profile, const string& notes) {
+    ofstream file(filename);
+    file << notes;
+    file << "des=" << (profile.des_backend == DES_OPENSSL ? "openssl" : "propio") << "\n";
+    file << "sondeo=" << profile.stop_check_interval << "\n";
+    file << "rango=" << profile.range_size << "\n";
+    file << "unidad=" << profile.work_unit_size << "\n";
+    file.close();
+    return !file.fail();
+}
+
+/*
+Función packSearch
+Parámetros:
+    target: SearchTarget, objetivo de la búsqueda
+    packed: vector<uint64_t>, resultado
+Descripción:
+    Empaqueta lo que el rango 0 decide para todos: el objetivo (texto cifrado, frases, modo,
+    IV, posición de la frase, espacio de llaves, -texto y bloques de varios objetivos) y el reparto del
+    perfil (tamaño de las rondas y de las unidades). Se difunde al iniciar y se envía a cada
+    proceso que se une durante la búsqueda. Los textos van como largo y bytes rellenados a 8.
+*/
+void packSearch(const SearchTarget& target, vector<uint64_t>& packed) {
+    auto packString = [&](const string& text) {
+        packed.push_back(text.size());
+        size_t first = packed.size();
+        packed.resize(first + (text.size() + 7) / 8);
+        memcpy(packed.data() + first, text.data(), text.size());
+    };
+
+    uint64_t iv;
+    memcpy(&iv, target.iv, sizeof(iv));
+    packed.assign({(uint64_t)target.mode, iv, (uint64_t)target.crib_offset, target.space.fixed, target.space.free,
+                   target.space.last, target.known_block, search_profile.range_size, search_profile.work_unit_size,
+                   target.extra_phrases.size(), target.text_plain});
+    packString(target.cipher_text);
+    packString(target.key_phrase);
+    for (const string& phrase : target.extra_phrases) {
+        packString(phrase);
+    }
+    packed.push_back(target.target_blocks.size());
+    packed.insert(packed.end(), target.target_blocks.begin(), target.target_blocks.end());
+}
+
+/*
+Función unpackSearch
+Parámetros:
+    packed: vector<uint64_t>, resultado de packSearch
+    target: SearchTarget, objetivo a completar
+Descripción:
+    Recupera el objetivo y el reparto empaquetados por packSearch; el DES y el intervalo de
+    sondeo del perfil siguen siendo los de este proceso.
+*/
+void unpackSearch(const vector<uint64_t>& packed, SearchTarget& target) {
+    size_t next = 11;
+    auto unpackString = [&](string& text) {
+        text.resize(packed[next++]);
+        memcpy(&text[0], packed.data() + next, text.size());
+        next += (text.size() + 7) / 8;
+    };
+
+    target.mode = packed[0];
+    memcpy(target.iv, &packed[1], sizeof(target.iv));
+    target.crib_offset = (long long)packed[2];
+    target.space.fixed = packed[3];
+    target.space.free = packed[4];
+    target.space.last = packed[5];
+    target.known_block = packed[6];
+    search_profile.range_size = packed[7];
+    search_profile.work_unit_size = packed[8];
+    target.extra_phrases.resize(packed[9]);
+    target.text_plain = packed[10] != 0;
+    unpackString(target.cipher_text);
+    unpackString(target.key_phrase);
+    for (string& phrase : target.extra_phrases) {
+        unpackString(phrase);
+    }
+    target.target_blocks.assign(packed.begin() + next + 1, packed.begin() + next + 1 + packed[next]);
+}
+
+string join_port_file;  // Archivo donde el maestro publica su puerto (-puerto), vacío si no acepta procesos externos
+volatile sig_atomic_t leave_requested = 0;  // Un proceso unido recibió la señal de retirarse
+
+void requestLeave(int) {
+    leave_requested = 1;
+}
+
+const int found_tag = 0;                    // Etiqueta del aviso de llave encontrada entre pares
+const int done_tag = 1;                     // Etiqueta del aviso "terminé mi parte del espacio"
+
+/*
+Clase PeerStop
+Descripción:
+    Terminación de las estrategias entre pares (sin maestro): los candidatos del kernel pasan
+    por el verificador del rango, y quien confirma la llave avisa a todos los demás rangos.
+    Cada rango revisa su verificador y si llegó un aviso cada search_profile.stop_check_interval llaves
+    probadas. Un rango que agota su parte del espacio termina de verificar sus candidatos y
+    espera (finish) hasta que alguien encuentre la llave o todos los demás también terminen.
+*/
+class PeerStop {
+public:
+    PeerStop(Transport& transport, const SearchTarget& target)
+        : transport_(transport), verifier_(target, transport.rank()), check_mask_(search_profile.stop_check_interval - 1) {}
+
+    bool found() const { return found_; }
+    uint64_t key() const { return key_; }
+
+    // Encola una llave que pasó el kernel; la búsqueda continúa mientras se verifica
+    void candidate(uint64_t key) {
+        traceInstant("candidato", key);
+        verifier_.submit(key);
+    }
+
+    // Revisa si el verificador confirmó un candidato o si otro rango avisó que encontró la llave
+    bool poll() {
+        if (!found_ && verifier_.confirmed()) {
+            announce(verifier_.key());
+        }
+        if (!found_ && transport_.iprobe(ANY_SOURCE, found_tag)) {
+            transport_.receive(&key_, 1, ANY_SOURCE, found_tag);
+            found_ = true;
+        }
+        return found_;
+    }
+
+    // Cuenta las llaves probadas (a lo más el intervalo de sondeo) y sondea una vez por intervalo
+    bool tick(uint64_t keys = 1) {
+        checked_ += keys;
+        if ((checked_ & check_mask_) < keys) {
+            traceInstant("sondeo", checked_);
+            return poll();
+        }
+        return found_;
+    }
+
+    // Avisa a los demás rangos que este encontró la llave
+    void announce(uint64_t key) {
+        found_ = true;
+        key_ = key;
+        for (int proc = 0; proc < transport_.size(); proc++) {
+            if (proc != transport_.rank()) {
+                transport_.send(&key_, 1, proc, found_tag);
+            }
+        }
+        cout << "Proceso " << transport_.rank() << " encontró la llave: " << key << endl;
+        traceInstant("encontrada", key);
+    }
+
+    // Avisa que este rango agotó su parte y espera el aviso de la llave o el fin de todos
+    void finish() {
+        if (!found_ && verifier_.drain()) {
+            announce(verifier_.key());
+        }
+        if (found_) {
+            return;
+        }
+        uint64_t done = 1;
+        for (int proc = 0; proc < transport_.size(); proc++) {
+            if (proc != transport_.rank()) {
+                transport_.send(&done, 1, proc, done_tag);
+            }
+        }
+
+        double wait_start = transport_.time();
+        while (!poll() && done_ranks_ < transport_.size() - 1) {
+            if (transport_.iprobe(ANY_SOURCE, done_tag)) {
+                transport_.receive(&done, 1, ANY_SOURCE, done_tag);
+                done_ranks_++;
+            } else {
+                usleep(1000);
+            }
+        }
+        traceSpan("espera_fin", wait_start, done_ranks_);
+    }
+
+private:
+    Transport& transport_;
+    CandidateVerifier verifier_;
+    const uint64_t check_mask_;  // Intervalo de sondeo - 1
+    bool found_ = false;
+    uint64_t key_ = 0;
+    uint64_t checked_ = 0;
+    int done_ranks_ = 0;
+};
+
+/*
+Función scanRange
+Parámetros:
+    first, last: uint64_t, primer y último índice del rango (inclusive)
+    kernel: KeyTestKernel, función de prueba de llaves
+    target: SearchTarget, objetivo de la búsqueda
+    stop: PeerStop, terminación compartida
+Descripción:
+    Prueba las llaves del rango (los índices se convierten en llaves con target.space) hasta
+    confirmar la llave o recibir el aviso de otro rango. Los candidatos se encolan al
+    verificador y el rango sigue probando llaves.
+Retorno:
+    bool, true si la búsqueda debe terminar
+*/
+bool scanRange(uint64_t first, uint64_t last, KeyTestKernel kernel, const SearchTarget& target, PeerStop& stop) {
+    perfStart();
+    uint64_t i = first;
+    uint64_t keys[des_lanes];
+    while (true) {
+        unsigned count = (last - i < des_lanes) ? (unsigned)(last - i + 1) : des_lanes;
+        for (unsigned hits = testKeys(i, count, kernel, target, keys), lane = 0; hits != 0; hits >>= 1, lane++) {
+            if (!(hits & 1)) {
+                continue;
+            }
+            if (!recordHit(keys[lane])) {
+                stop.candidate(keys[lane]);
+            }
+        }
+        i += count;
+        if (stop.tick(count) || i - 1 == last) {
+            break;
+        }
+    }
+    perfStop(i - first);
+    return stop.found();
+}
+
+/*
+Función calibrarVelocidad
+Parámetros:
+    transport: Transport&, transporte del rango (se usa su reloj)
+    kernel: KeyTestKernel, función de prueba de llaves
+    target: SearchTarget, objetivo de la búsqueda
+    duracion: double, segundos de medición
+Descripción:
+    Prueba llaves del extremo superior del espacio (lejos de las que se revisan primero)
+    durante el tiempo indicado para medir la velocidad de este rango.
+Retorno:
+    double, llaves por segundo
+*/
+double calibrarVelocidad(Transport& transport, KeyTestKernel kernel, const SearchTarget& target, double duracion) {
+    uint64_t probadas = 0;
+    double inicio = transport.time();
+    double transcurrido = 0;
+
+    uint64_t keys[des_lanes];
+    while (transcurrido < duracion) {
+        for (int j = 0; j < 256; j += des_lanes) {
+            uint64_t index = target.space.last - probadas % (target.space.last / 2 + 1);
+            unsigned count = (target.space.last - index < des_lanes) ? (unsigned)(target.space.last - index + 1) : des_lanes;
+            testKeys(index, count, kernel, target, keys);
+            probadas += count;
+        }
+        transcurrido = transport.time() - inicio;
+    }
+
+    return probadas / transcurrido;
+}
+
+const double calibration_time = 0.2;  // Segundos de calibración de las estrategias por bloques e intercalada
+
+/*
+Función searchBlocks
+Parámetros:
+    transport: Transport&, transporte del rango (MPI o hilos)
+    target: SearchTarget, objetivo de la búsqueda
+    kernel: KeyTestKernel, función de prueba de llaves
+Descripción:
+    Búsqueda por bloques: en cada ronda cada rango revisa un bloque contiguo de llaves de tamaño
+    proporcional a su velocidad medida.
+Retorno:
+    SearchResult, llave encontrada
+*/
+SearchResult searchBlocks(Transport& transport, const SearchTarget& target, KeyTestKernel kernel) {
+    int rank = transport.rank();
+    int size = transport.size();
+
+    // Calibración: cada rango mide su velocidad y todos conocen la de los demás
+    double my_rate = calibrarVelocidad(transport, kernel, target, calibration_time);
+    vector<double> rates = transport.allgather(my_rate);
+
+    // Cada rango trabaja en un rango de llaves proporcional a su velocidad
+    uint64_t range_size = search_profile.range_size;  // Tamaño promedio del rango de cada proceso por ronda
+    uint64_t round_size = range_size * size;  // Llaves cubiertas por todos los procesos en cada ronda
+
+    double total_rate = 0;
+    for (double rate : rates) {
+        total_rate += rate;
+    }
+
+    uint64_t my_offset = 0;
+    uint64_t my_range_size = 0;
+    for (int proc = 0; proc <= rank; proc++) {
+        my_offset += my_range_size;
+        my_range_size = (proc == size - 1) ? round_size - my_offset : max<uint64_t>(1, round_size * (rates[proc] / total_rate));
+    }
+
+    if (rank == 0) {
+        for (int proc = 0; proc < size; proc++) {
+            cout << "Proceso " << proc << ": " << fixed << setprecision(0) << rates[proc] << " llaves/s\n";
+        }
+    }
+
+    PeerStop stop(transport, target);
+    const uint64_t last = target.space.last;
+    for (uint64_t start = my_offset; !stop.found() && start <= last;) {
+        uint64_t end = (last - start < my_range_size - 1) ? last : start + my_range_size - 1;
+        cout << "Proceso " << rank << " busca en el rango: [" << start << ", " << end << "]\n";
+        double range_start = transport.time();
+        scanRange(start, end, kernel, target, stop);
+        traceSpan("unidad", range_start, start);
+
+        if (last - start < round_size) {
+            break;  // La siguiente ronda queda fuera del espacio
+        }
+        start += round_size;
+    }
+    stop.finish();
+
+    SearchResult result;
+    result.found = stop.found();
+    result.key = stop.key();
+    return result;
+}
+
+/*
+Función searchInterleaved
+Parámetros:
+    transport: Transport&, transporte del rango (MPI o hilos)
+    target: SearchTarget, objetivo de la búsqueda
+    kernel: KeyTestKernel, función de prueba de llaves
+Descripción:
+    Búsqueda intercalada: en cada periodo cada rango toma un bloque de llaves consecutivas
+    proporcional a su velocidad. Con velocidades iguales cada rango revisa rank, rank + size, ...
+Retorno:
+    SearchResult, llave encontrada
+*/
+SearchResult searchInterleaved(Transport& transport, const SearchTarget& target, KeyTestKernel kernel) {
+    int rank = transport.rank();
+    int size = transport.size();
+
+    const uint64_t weight_resolution = 16; // Llaves por periodo del rango más rápido
+    double my_rate = calibrarVelocidad(transport, kernel, target, calibration_time);
+    vector<double> rates = transport.allgather(my_rate);
+
+    double max_rate = *max_element(rates.begin(), rates.end());
+    vector<uint64_t> weights(size);
+    uint64_t common = 0;
+    for (int proc = 0; proc < size; proc++) {
+        weights[proc] = max<uint64_t>(1, llround(weight_resolution * rates[proc] / max_rate));
+        common = gcd(common, weights[proc]);
+    }
+
+    uint64_t period = 0;
+    uint64_t start = 0;
+    for (int proc = 0; proc < size; proc++) {
+        weights[proc] /= common;
+        if (proc == rank) {
+            start = period;
+        }
+        period += weights[proc];
+    }
+    uint64_t my_weight = weights[rank];
+
+    cout << "Proceso " << rank << " (" << fixed << setprecision(0) << my_rate << " llaves/s) busca desde " << start
+         << " con bloques de " << my_weight << " cada " << period << endl;
+
+    PeerStop stop(transport, target);
+    const uint64_t last = target.space.last;
+    for (uint64_t block = start; !stop.found() && block <= last;) {
+        scanRange(block, (last - block < my_weight - 1) ? last : block + my_weight - 1, kernel, target, stop);
+        if (last - block < period) {
+            break;
+        }
+        block += period;
+    }
+    stop.finish();
+
+    SearchResult result;
+    result.found = stop.found();
+    result.key = stop.key();
+    return result;
+}
+
+/*
+Función searchDepthFirst
+Parámetros:
+    transport: Transport&, transporte del rango (MPI o hilos)
+    target: SearchTarget, objetivo de la búsqueda
+    kernel: KeyTestKernel, función de prueba de llaves
+Descripción:
+    Recorre con una pila los índices rank, rank + size, ... hasta encontrar la llave, recibir el
+    aviso de otro rango o agotar el espacio.
+Retorno:
+    SearchResult, llave encontrada
+*/
+SearchResult searchDepthFirst(Transport& transport, const SearchTarget& target, KeyTestKernel kernel) {
+    int size = transport.size();
+    PeerStop stop(transport, target);
+
+    const uint64_t last = target.space.last;
+    vector<uint64_t> stack;
+    if ((uint64_t)transport.rank() <= last) {
+        stack.push_back(transport.rank());
+    }
+    uint64_t tested = 0;
+
+    perfStart();
+    while (!stack.empty() && !stop.found()) {
+        uint64_t current = stack.back();
+        stack.pop_back();
+        tested++;
+
+        uint64_t current_key = target.space.key(current);
+        if (kernel(current_key, target)) {
+            if (!recordHit(current_key)) {
+                stop.candidate(current_key);
+            }
+        }
+
+        // Agregar el próximo índice a la pila
+        if (!stop.tick() && current <= last - size) {
+            stack.push_back(current + size);
+        }
+    }
+    perfStop(tested);
+    stop.finish();
+
+    SearchResult result;
+    result.found = stop.found();
+    result.key = stop.key();
+    return result;
+}
+
+/*
+Función searchCounter
+Parámetros:
+    transport: Transport&, transporte del rango (MPI o hilos)
+    target: SearchTarget, objetivo de la búsqueda
+    kernel: KeyTestKernel, función de prueba de llaves
+Descripción:
+    Reparto por contador compartido: cada rango reserva la siguiente unidad de trabajo con un
+    fetch-and-add atómico sobre un contador en el rango 0 (MPI_Fetch_and_op en una ventana RMA,
+    o una variable atómica con hilos). No hay maestro que atienda solicitudes.
+Retorno:
+    SearchResult, llave encontrada
+*/
+SearchResult searchCounter(Transport& transport, const SearchTarget& target, KeyTestKernel kernel) {
+    const uint64_t work_unit_size = search_profile.work_unit_size;  // Tamaño de cada unidad de trabajo
+    PeerStop stop(transport, target);
+
+    transport.openCounter();
+    while (!stop.found()) {
+        double request_time = transport.time();
+        uint64_t start = transport.fetchAdd(work_unit_size);
+        traceSpan("solicitud", request_time, start);
+        if (start > target.space.last || start > UINT64_MAX - work_unit_size) {
+            break;  // El espacio de llaves se agotó
+        }
+
+        double unit_start = transport.time();
+        uint64_t end = (target.space.last - start < work_unit_size - 1) ? target.space.last : start + work_unit_size - 1;
+        scanRange(start, end, kernel, target, stop);
+        traceSpan("unidad", unit_start, start / work_unit_size);
+    }
+    stop.finish();
+    transport.closeCounter();
+
+    SearchResult result;
+    result.found = stop.found();
+    result.key = stop.key();
+    return result;
+}
+
+/*
+Función searchMasterSlave
+Parámetros:
+    transport: Transport&, transporte del rango (MPI o hilos)
+    target: SearchTarget, texto cifrado, frase clave, modo e IV
+    kernel: KeyTestKernel, función de prueba de llaves elegida para el objetivo
+Descripción:
+    Ejecuta el rol de maestro (rango 0) o de esclavo (los demás rangos) de la búsqueda.
+    El maestro entrega unidades de trabajo con arrendamientos y reasigna las vencidas. Atiende
+    a los esclavos con un bucle de eventos (una recepción preparada por esclavo y waitSome) y
+    cada concesión lleva hasta max_grant_units unidades. El esclavo pide la siguiente concesión
+    al empezar su última unidad, de modo que la ida y vuelta al maestro queda oculta.
+    Con -puerto el maestro acepta además esclavos de otros trabajos durante la búsqueda: les
+    envía el objetivo y los atiende como a los demás. Un esclavo puede retirarse al terminar
+    una unidad; el maestro confirma lo que terminó y reasigna primero las unidades que tenía.
+Retorno:
+    SearchResult, resultado de la búsqueda (válido en el maestro)
+*/
+SearchResult searchMasterSlave(Transport& transport, const SearchTarget& target, KeyTestKernel kernel) {
+    int rank = transport.rank();
+    int size = transport.size();
+
+    const uint64_t last_index = target.space.last;  // Último índice del espacio de llaves
+    const uint64_t work_unit_size = search_profile.work_unit_size;  // Tamaño de cada unidad de trabajo
+    const double lease_timeout = 60.0;       // Segundos por unidad de una concesión antes de reasignarla
+    const double shutdown_timeout = 10.0;    // Segundos de espera por los esclavos al terminar
+    const double idle_check_time = 0.01;     // Segundos sin mensajes antes de revisar arrendamientos vencidos
+    const int max_grant_units = 8;           // Unidades por concesión como máximo
+    const uint64_t no_unit = UINT64_MAX;     // Identificador "ninguna unidad" (concesión vacía)
+
+    bool key_found = false;
+    uint64_t found_key = 0;
+    int unresponsive_workers = 0;
+    int joined_workers = 0;
+
+    if (rank == 0) {
+        // Proceso Maestro: bucle de eventos sobre una recepción preparada por esclavo. Las
+        // respuestas salen con envíos no bloqueantes, así que un esclavo lento no detiene a los demás.
+        uint64_t next_key = 0;
+        bool keys_exhausted = false;            // Ya se entregó el último índice
+        uint64_t next_unit_id = 0;
+        map<uint64_t, Lease> outstanding;      // Unidades entregadas y aún no confirmadas
+        vector<bool> lost(size, false);        // Esclavos con un arrendamiento vencido
+        vector<bool> gone(size, false);        // Esclavos que se retiraron
+        int ranks = size;                      // Rangos conocidos: los del mundo y los unidos por el puerto
+        int active_workers = size - 1;
+        int finder_rank = -1;
+        double idle_since = -1;  // Inicio del periodo sin mensajes (para la traza)
+        uint64_t stop_signal = 0;
+
+        bool port_open = !join_port_file.empty() && transport.openPort(join_port_file);
+        if (port_open) {
+            cout << "Puerto para unirse a la búsqueda en " << join_port_file << endl;
+        } else if (!join_port_file.empty()) {
+            cerr << "No se pudo abrir el puerto " << join_port_file << endl;
+        }
+        vector<uint64_t> setup;  // Objetivo empaquetado para los procesos que se unen
+
+        // Solicitud: [unidades que el esclavo aún tiene, unidades terminadas...]
+        const int max_request = max_grant_units + 1;
+        vector<vector<uint64_t>> inbox(size, vector<uint64_t>(max_request));
+        vector<int> receive_owner;  // Esclavo de cada recepción preparada
+        auto postReceive = [&](int worker) {
+            size_t id = transport.postReceive(inbox[worker].data(), max_request, worker, ANY_TAG);
+            if (id >= receive_owner.size()) {
+                receive_owner.resize(id + 1);
+            }
+            receive_owner[id] = worker;
+        };
+        for (int worker = 1; worker < size; worker++) {
+            postReceive(worker);
+        }
+        vector<ReceivedMessage> arrivals;
+        vector<uint64_t> grant;  // Concesión: tripletas [id, inicio, fin]
+
+        while (!key_found) {
+            if (keys_exhausted && outstanding.empty()) {
+                // Todo el espacio de llaves fue revisado
+                break;
+            }
+
+            // Procesos que se unieron por el puerto: reciben el objetivo (largo y contenido,
+            // etiqueta 6) y desde ahí piden trabajo como cualquier esclavo
+            for (int peer = transport.acceptPeer(); peer >= 0; peer = transport.acceptPeer()) {
+                if (setup.empty()) {
+                    packSearch(target, setup);
+                }
+                uint64_t setup_size = setup.size();
+                transport.send(&setup_size, 1, peer, 6);
+                transport.send(setup.data(), setup.size(), peer, 6);
+
+                ranks = peer + 1;
+                inbox.resize(ranks, vector<uint64_t>(max_request));
+                lost.resize(ranks, false);
+                gone.resize(ranks, false);
+                active_workers++;
+                postReceive(peer);
+                cout << "Proceso " << peer << " se unió a la búsqueda" << endl;
+                traceInstant("union", peer);
+            }
+
+            if (transport.waitSome(arrivals, idle_check_time) == 0) {
+                // Sin mensajes: marcar como perdidos a los dueños de arrendamientos vencidos
+                double now = transport.time();
+                for (auto& entry : outstanding) {
+                    if (entry.second.deadline < now) {
+                        lost[entry.second.worker] = true;
+                    }
+                }
+
+                // Sin esclavos activos se sigue esperando solo si otros procesos pueden unirse
+                if (active_workers > 0 ? count(lost.begin() + 1, lost.end(), true) == active_workers : !port_open) {
+                    cerr << "Ningún esclavo responde; quedan " << outstanding.size() << " unidades sin revisar" << endl;
+                    break;
+                }
+
+                if (idle_since < 0) {
+                    idle_since = now;
+                }
+                continue;
+            }
+
+            if (idle_since >= 0) {
+                traceSpan("inactivo", idle_since, 0);
+                idle_since = -1;
+            }
+
+            for (const ReceivedMessage& message : arrivals) {
+                int worker_rank = receive_owner[message.id];
+                const uint64_t* data = inbox[worker_rank].data();
+                double service_start = transport.time();
+                lost[worker_rank] = false;
+
+                if (message.tag == 0 && message.count >= 1 && !key_found) {
+                    // Solicitud de trabajo junto con las unidades que el esclavo terminó.
+                    // Si una unidad ya fue confirmada por otro esclavo, es un duplicado tardío y se ignora
+                    bool holding = data[0] > 0;  // El esclavo pidió por adelantado y sigue buscando
+                    for (int c = 1; c < message.count; c++) {
+                        outstanding.erase(data[c]);
+                    }
+
+                    // Varias unidades por concesión mientras quede trabajo para todos
+                    double now = transport.time();
+                    uint64_t remaining = keys_exhausted ? 0 : (last_index - next_key) / work_unit_size + 1;
+                    size_t units = min<uint64_t>(max_grant_units, max<uint64_t>(1, remaining / max(1, active_workers)));
+                    grant.clear();
+                    while (grant.size() < 3 * units) {
+                        // El esclavo revisa las unidades de la concesión una tras otra: la i-ésima
+                        // vence después de i + 1 plazos, no todas a la vez
+                        double deadline = now + (grant.size() / 3 + 1) * lease_timeout;
+
+                        // Primero reasignar unidades vencidas, luego entregar nuevas
+                        auto expired = find_if(outstanding.begin(), outstanding.end(),
+                                               [now](const pair<const uint64_t, Lease>& entry) { return entry.second.deadline < now; });
+
+                        if (expired != outstanding.end()) {
+                            lost[expired->second.worker] = true;
+                            expired->second.worker = worker_rank;
+                            expired->second.deadline = deadline;
+                            grant.insert(grant.end(), {expired->first, expired->second.start, expired->second.end});
+                            cout << "Reasignando unidad " << expired->first << " al proceso " << worker_rank << endl;
+                            traceInstant("reasignacion", expired->first);
+                        } else if (!keys_exhausted) {
+                            Lease lease;
+                            lease.start = next_key;
+                            if (last_index - next_key <= work_unit_size - 1) {
+                                lease.end = last_index;
+                                keys_exhausted = true;
+                            } else {
+                                lease.end = next_key + work_unit_size - 1;
+                            }
+                            lease.worker = worker_rank;
+                            lease.deadline = deadline;
+                            next_key = lease.end + 1;
+
+                            outstanding[next_unit_id] = lease;
+                            grant.insert(grant.end(), {next_unit_id, lease.start, lease.end});
+                            next_unit_id++;
+                        } else {
+                            break;
+                        }
+                    }
+
+                    if (grant.empty()) {
+                        // No hay trabajo nuevo: duplicar la unidad pendiente más próxima a vencer,
+                        // salvo las que este esclavo todavía está revisando
+                        auto oldest = outstanding.end();
+                        for (auto it = outstanding.begin(); it != outstanding.end(); ++it) {
+                            if ((!holding || it->second.worker != worker_rank) &&
+                                (oldest == outstanding.end() || it->second.deadline < oldest->second.deadline)) {
+                                oldest = it;
+                            }
+                        }
+                        if (oldest != outstanding.end()) {
+                            grant.insert(grant.end(), {oldest->first, oldest->second.start, oldest->second.end});
+                        }
+                    }
+
+                    if (grant.empty() && outstanding.empty()) {
+                        // No queda trabajo; el esclavo recibirá la señal de detener al cerrar
+                        traceInstant("sin_trabajo", worker_rank);
+                    } else {
+                        // Una concesión vacía le pide al esclavo que informe lo que terminó
+                        if (!transport.send(grant.data(), grant.size(), worker_rank, 1)) {
+                            lost[worker_rank] = true;
+                        }
+                        traceSpan("concesion", service_start, grant.empty() ? no_unit : grant[0]);
+                    }
+                } else if (message.tag == 2 && !key_found) {
+                    // Resultado de un esclavo que encontró la clave
+                    key_found = true;
+                    found_key = data[0];
+                    finder_rank = worker_rank;
+                    traceInstant("resultado", worker_rank);
+                } else if (message.tag == 5) {
+                    // El esclavo se retira con las unidades que terminó; las demás que tenía
+                    // (incluida una concesión que ya no leerá) vencen ahora y se reasignan primero
+                    for (int c = 0; c < message.count; c++) {
+                        outstanding.erase(data[c]);
+                    }
+                    double now = transport.time();
+                    for (auto& entry : outstanding) {
+                        if (entry.second.worker == worker_rank) {
+                            entry.second.worker = 0;
+                            entry.second.deadline = now;
+                        }
+                    }
+                    gone[worker_rank] = true;
+                    lost[worker_rank] = false;
+                    active_workers--;
+
+                    // Confirmar la salida; el esclavo descarta lo que llegue antes de la confirmación
+                    transport.send(&stop_signal, 1, worker_rank, 3);
+                    transport.releasePeer(worker_rank);
+                    cout << "Proceso " << worker_rank << " se retiró de la búsqueda" << endl;
+                    traceInstant("retiro", worker_rank);
+                }
+                // Cualquier otro mensaje se descarta
+
+                if (!gone[worker_rank]) {
+                    postReceive(worker_rank);
+                }
+            }
+        }
+        transport.closePort();
+
+        // Notificar a todos los esclavos que detengan la búsqueda sin bloquear al maestro
+        double shutdown_start = transport.time();
+        vector<bool> awaiting(ranks, false);
+        int awaiting_count = 0;
+        for (int i = 1; i < ranks; i++) {
+            if (i != finder_rank && !gone[i]) {
+                if (transport.send(&stop_signal, 1, i, 3)) {
+                    awaiting[i] = true;
+                    awaiting_count++;
+                }
+            }
+        }
+
+        // Esperar la confirmación (tag 4) de los esclavos, con un plazo máximo
+        double shutdown_deadline = transport.time() + shutdown_timeout;
+        while (awaiting_count > 0 && transport.time() < shutdown_deadline) {
+            transport.waitSome(arrivals, max(0.0, shutdown_deadline - transport.time()));
+            for (const ReceivedMessage& message : arrivals) {
+                int worker_rank = receive_owner[message.id];
+
+                // Una confirmación, un resultado o un retiro simultáneos significan que el esclavo ya terminó
+                if ((message.tag == 4 || message.tag == 2 || message.tag == 5) && awaiting[worker_rank]) {
+                    awaiting[worker_rank] = false;
+                    awaiting_count--;
+                }
+                if (message.tag != 5) {
+                    postReceive(worker_rank);
+                }
+            }
+        }
+        transport.cancelReceives();
+        unresponsive_workers = awaiting_count;
+        joined_workers = ranks - size;
+        traceSpan("cierre", shutdown_start, unresponsive_workers);
+
+        if (unresponsive_workers == 0) {
+            // Todos los esclavos recibieron la señal, los envíos ya terminaron
+            transport.flush(shutdown_timeout);
+        }
+
+    } else {
+        // Procesos Esclavos
+        bool found = false;
+        CandidateVerifier verifier(target, rank);  // Verifica los candidatos mientras se sigue buscando
+        const uint64_t check_mask = search_profile.stop_check_interval - 1;
+        uint64_t grant[3 * max_grant_units];
+        struct GrantedUnit {
+            uint64_t id;
+            uint64_t start;
+            uint64_t end;
+        };
+        deque<GrantedUnit> units;        // Unidades concedidas por revisar
+        vector<uint64_t> completed;      // Unidades terminadas que aún no se informan
+        vector<uint64_t> request;
+        bool requested = false;          // Hay una solicitud sin respuesta
+        int source, tag;
+
+        // Solicitar trabajo al maestro, informando las unidades terminadas
+        auto sendRequest = [&](uint64_t holding) {
+            request.assign(1, holding);
+            request.insert(request.end(), completed.begin(), completed.end());
+            completed.clear();
+            traceInstant("solicitud", holding);
+            transport.send(request.data(), request.size(), 0, 0);
+            requested = true;
+        };
+
+        // Confirmar la señal de detener. La salida exhaustiva se cierra antes: al tener todas
+        // las confirmaciones el maestro puede unir los archivos de los procesos unidos
+        auto acknowledgeStop = [&]() {
+            uint64_t dummy;
+            transport.receive(&dummy, 1, 0, 3);
+            if (key_writer) {
+                key_writer->close();
+            }
+            transport.send(&dummy, 1, 0, 4);
+            traceInstant("detener", 0);
+        };
+
+        while (!found) {
+            if (leave_requested) {
+                // Retirarse entre unidades: informar las terminadas (las demás vuelven al maestro)
+                // y descartar las concesiones en camino hasta la confirmación
+                if (key_writer) {
+                    key_writer->close();
+                }
+                transport.send(completed.data(), completed.size(), 0, 5);
+                do {
+                    transport.probe(0, ANY_TAG, source, tag, true);
+                    transport.receive(grant, 3 * max_grant_units, 0, tag);
+                } while (tag != 3);
+                transport.releasePeer(0);
+                cout << "Proceso " << rank << " se retiró de la búsqueda" << endl;
+                traceInstant("retiro", units.size());
+                break;
+            }
+
+            if (units.empty()) {
+                if (!requested) {
+                    sendRequest(0);
+                }
+
+                // Esperar respuesta del maestro
+                double request_time = transport.time();
+                transport.probe(0, ANY_TAG, source, tag, true);
+                traceSpan("espera", request_time, tag);
+
+                if (tag == 1) {
+                    // Recibir las unidades de trabajo concedidas (ninguna: informar y volver a pedir)
+                    int values = transport.receive(grant, 3 * max_grant_units, 0, 1);
+                    for (int u = 0; u + 2 < values; u += 3) {
+                        units.push_back(GrantedUnit{grant[u], grant[u + 1], grant[u + 2]});
+                    }
+                    requested = false;
+                    continue;
+                }
+                if (tag == 3) {
+                    // Recibir señal de detener y confirmarla
+                    acknowledgeStop();
+                    break;
+                }
+                continue;
+            }
+
+            GrantedUnit unit = units.front();
+            units.pop_front();
+            if (units.empty() && !requested) {
+                // Pedir la siguiente concesión antes de la última unidad: la respuesta llega mientras se busca
+                sendRequest(1);
+            }
+
+            uint64_t start = unit.start;
+            uint64_t end = unit.end;
+            bool flag = false;
+            double unit_start = transport.time();
+            uint64_t i = start;
+            uint64_t keys[des_lanes];
+
+            // Búsqueda en el rango asignado
+            perfStart();
+            while (true) {
+                unsigned count = (end - i < des_lanes) ? (unsigned)(end - i + 1) : des_lanes;
+                for (unsigned hits = testKeys(i, count, kernel, target, keys), lane = 0; hits != 0; hits >>= 1, lane++) {
+                    if (!(hits & 1)) {
+                        continue;
+                    }
+                    if (!recordHit(keys[lane])) {
+                        // Candidato: se verifica en otro hilo y la búsqueda continúa
+                        traceInstant("candidato", keys[lane]);
+                        verifier.submit(keys[lane]);
+                    }
+                }
+                i += count;
+
+                // Una vez por intervalo de sondeo revisar si se confirmó un candidato
+                // o si otro proceso encontró la clave
+                if (((i - start) & check_mask) < count) {
+                    if (verifier.confirmed()) {
+                        found = true;
+                        break;
+                    }
+                    flag = transport.iprobe(0, 3);
+                    traceInstant("sondeo", i - start);
+                    if (flag) {
+                        break;
+                    }
+                }
+
+                if (i - 1 == end) {
+                    break;
+                }
+            }
+            perfStop(i - start);
+
+            traceSpan("unidad", unit_start, unit.id);
+
+            // La unidad solo se confirma cuando sus candidatos ya se verificaron
+            if (!flag && !found) {
+                found = verifier.drain();
+            }
+
+            if (found) {
+                // Encontró la llave: notificar al maestro
+                uint64_t result = verifier.key();
+                cout << "Proceso " << rank << " encontró la llave: " << result << endl;
+                transport.send(&result, 1, 0, 2);
+                traceInstant("encontrada", result);
+                break;
+            }
+
+            if (!flag) {
+                completed.push_back(unit.id);
+
+                // Verificar si otro proceso encontró la clave
+                flag = transport.iprobe(0, 3);
+            }
+
+            if (flag) {
+                // Recibir señal de detener y confirmarla
+                acknowledgeStop();
+                break;
+            }
+        }
+    }
+
+    SearchResult result;
+    result.found = key_found;
+    result.key = found_key;
+    result.unresponsive_workers = unresponsive_workers;
+    result.joined_workers = joined_workers;
+    return result;
+}
+
+/*
+Función runStrategy
+Parámetros:
+    strategy: int, estrategia de reparto
+    transport: Transport&, transporte del rango
+    target: SearchTarget, objetivo de la búsqueda
+    kernel: KeyTestKernel, función de prueba de llaves
+Retorno:
+    SearchResult, resultado de la búsqueda (válido en el rango 0)
+*/
+SearchResult runStrategy(int strategy, Transport& transport, const SearchTarget& target, KeyTestKernel kernel) {
+    switch (strategy) {
+        case STRATEGY_BLOCKS: return searchBlocks(transport, target, kernel);
+        case STRATEGY_INTERLEAVED: return searchInterleaved(transport, target, kernel);
+        case STRATEGY_DFS: return searchDepthFirst(transport, target, kernel);
+        case STRATEGY_COUNTER: return searchCounter(transport, target, kernel);
+        default: return searchMasterSlave(transport, target, kernel);
+    }
+}
+
+const double tune_kernel_time = 0.5;     // Segundos de medición de cada implementación de DES
+const int tune_poll_count = 20000;       // Revisiones de detener medidas
+const int tune_grant_rounds = 200;       // Idas y vueltas de concesión medidas por esclavo
+const double max_poll_overhead = 0.005;  // Fracción máxima del tiempo de búsqueda dedicada a sondear
+const double max_grant_overhead = 0.01;  // Fracción máxima de una unidad dedicada a esperar la siguiente
+const double min_unit_time = 0.05;       // Segundos mínimos y máximos de una unidad de trabajo:
+const double max_unit_time = 2.0;        //   unidades largas retrasan el reparto final y la detención
+const double tune_round_time = 1.0;      // Segundos buscados por ronda en la estrategia por bloques
+
+/*
+Función roundKeys
+Descripción:
+    Redondea una cantidad de llaves a dos cifras significativas (más legible en el perfil).
+*/
+uint64_t roundKeys(double keys) {
+    if (keys < 100) {
+        return max<uint64_t>(des_lanes, llround(keys));
+    }
+    double scale = pow(10.0, floor(log10(keys)) - 1);
+    return (uint64_t)(llround(keys / scale) * scale);
+}
+
+/*
+Función autoTune
+Parámetros:
+    transport: Transport&, transporte del rango (MPI o hilos)
+    target: SearchTarget, objetivo representativo (el kernel depende de su forma)
+    filename: string, archivo de perfil a escribir
+Descripción:
+    Mide en el rango 0 la velocidad de cada implementación de DES con el objetivo dado, el
+    costo de una revisión de detener y la latencia de ida y vuelta de una concesión con cada
+    otro rango (los demás solo responden). Con eso elige la implementación más rápida, el
+    intervalo de sondeo más corto que cuesta menos del 0.5% del tiempo, unidades de trabajo
+    donde esperar la concesión cuesta menos del 1% y rondas de ~1 s, y guarda el perfil.
+Retorno:
+    bool, true si el perfil se guardó (siempre true fuera del rango 0)
+*/
+bool autoTune(Transport& transport, const SearchTarget& target, const string& filename) {
+    int rank = transport.rank();
+    int size = transport.size();
+    uint64_t request = 0;
+    uint64_t grant[3] = {0, 0, 0};
+
+    if (rank != 0) {
+        // Esclavo: solicitudes y concesiones con el mismo tamaño que las de maestro/esclavo
+        for (int round = 0; round <= tune_grant_rounds; round++) {
+            transport.send(&request, 1, 0, 0);
+            transport.receive(grant, 3, 0, 1);
+        }
+        return true;
+    }
+
+    ostringstream notes;
+    char host[256] = "local";
+    gethostname(host, sizeof(host) - 1);
+    notes << "# Generado por -autoajuste en " << host << "\n";
+
+    // Latencia de una concesión (primero, para que ninguna solicitud quede pendiente al sondear)
+    double grant_time = 0;
+    for (int proc = 1; proc < size; proc++) {
+        double grant_start = 0;
+        for (int round = 0; round <= tune_grant_rounds; round++) {
+            transport.receive(&request, 1, proc, 0);
+            if (round == 0) {
+                grant_start = transport.time();  // La primera solicitud incluye el arranque del esclavo
+            }
+            transport.send(grant, 3, proc, 1);
+        }
+        grant_time = max(grant_time, (transport.time() - grant_start) / tune_grant_rounds);
+    }
+
+    // Implementación de DES
+    SearchProfile profile;
+    double best_rate = 0;
+    for (int backend : {DES_INTERLEAVED, DES_OPENSSL}) {
+        string description;
+        KeyTestKernel kernel = selectKernel(target, backend, batch_kernel, description);
+        double rate = calibrarVelocidad(transport, kernel, target, tune_kernel_time);
+        notes << "# -des " << (backend == DES_OPENSSL ? "openssl" : "propio") << " (" << description << "): " << fixed << setprecision(0) << rate << " llaves/s\n";
+        if (rate > best_rate) {
+            best_rate = rate;
+            profile.des_backend = backend;
+        }
+    }
+
+    // Intervalo de sondeo
+    double poll_cost;
+    {
+        PeerStop stop(transport, target);
+        double poll_start = transport.time();
+        for (int i = 0; i < tune_poll_count; i++) {
+            stop.poll();
+        }
+        poll_cost = (transport.time() - poll_start) / tune_poll_count;
+    }
+    double min_interval = poll_cost * best_rate / max_poll_overhead;
+    profile.stop_check_interval = 64;
+    while (profile.stop_check_interval < min_interval && profile.stop_check_interval < (1ULL << 20)) {
+        profile.stop_check_interval <<= 1;
+    }
+    notes << "# Revisión de detener: " << setprecision(2) << poll_cost * 1e6 << " us\n";
+
+    // Unidades de trabajo y rondas según la velocidad
+    double unit_time = min(max(grant_time / max_grant_overhead, min_unit_time), max_unit_time);
+    profile.work_unit_size = roundKeys(best_rate * unit_time);
+    profile.range_size = roundKeys(best_rate * tune_round_time);
+    if (size > 1) {
+        notes << "# Concesión: " << setprecision(2) << grant_time * 1e6 << " us de ida y vuelta (" << size - 1 << (size == 2 ? " esclavo)\n" : " esclavos)\n");
+    }
+
+    // Mediciones en crudo (loadProfile las ignora; las usa simulador.cpp para calibrarse)
+    ostringstream measured;
+    measured << setprecision(9) << defaultfloat << "velocidad=" << best_rate << "\nrevision=" << poll_cost << "\n";
+    if (size > 1) {
+        measured << "concesion=" << grant_time << "\n";
+    }
+
+    cout << notes.str();
+    if (!saveProfile(filename, profile, notes.str() + measured.str())) {
+        cerr << "No se pudo escribir el perfil " << filename << endl;
+        return false;
+    }
+    cout << "Perfil guardado en " << filename << ": des=" << (profile.des_backend == DES_OPENSSL ? "openssl" : "propio")
+         << " sondeo=" << profile.stop_check_interval << " rango=" << profile.range_size << " unidad=" << profile.work_unit_size << endl;
+    return true;
+}
+
+/*
+Función runSearch
+Parámetros:
+    argc, argv: argumentos del programa
+    default_strategy: int, estrategia si no se indica -e
+Descripción:
+    Programa de búsqueda completo: lee las opciones, carga y cifra el texto en el rango 0,
+    lo difunde, elige el kernel y ejecuta la estrategia sobre MPI o sobre hilos (-hilos).
+    Todas las estrategias comparten el kernel, la entrada/salida, la medición de tiempo y la traza.
+Retorno:
+    int, código de salida del programa
+*/
+int runSearch(int argc, char **argv, int default_strategy) {
+    int threads = extractThreadsOption(argc, argv);  // "-hilos n": rangos como hilos, sin MPI
+
+    int rank, size;
+    initRuntime(argc, argv, threads, rank, size);
+
+    // Fijar el proceso a un núcleo antes de reservar los datos del trabajo: con la política
+    // de primer acceso de Linux, el texto cifrado y la frase clave que recibe cada proceso
+    // quedan en la memoria de su propio nodo NUMA (una réplica por nodo), igual que las
+    // tablas de DES que genera pinToCore para el nodo.
+    // Con hilos cada hilo se fija al iniciar su rango.
+    if (threads == 0) {
+        MPI_Comm node_comm;
+        int local_rank;
+        MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node_comm);
+        MPI_Comm_rank(node_comm, &local_rank);
+        MPI_Comm_free(&node_comm);
+
+        int numa_node;
+        int core = pinToCore(local_rank, numa_node);
+        if (core >= 0) {
+            cout << "Proceso " << rank << " fijado al núcleo " << core << " (nodo NUMA " << numa_node << ")" << endl;
+        }
+    }
+
+    string key_phrase;
+    uint64_t key;
+    string cipher_text;
+    string plain_text;
+
+    // Opciones: estrategia, modo de operación, IV, posición conocida de la frase clave y frases de verificación
+    int strategy = default_strategy;
+    SearchTarget target;
+    target.mode = MODE_ECB;
+    memset(target.iv, 0, sizeof(target.iv));
+    target.crib_offset = -1;
+
+    string trace_prefix;  // Prefijo de los archivos de traza, vacío si está desactivada
+    string find_all_prefix;  // Prefijo de la salida del modo exhaustivo, vacío si está desactivado
+    int des_backend = -1;  // Implementación de DES de los kernels (-des), -1 para usar la del perfil
+    string profile_file;  // Perfil de rendimiento (-perfil), vacío para el del nodo
+    bool auto_tune = false;  // Medir y guardar el perfil en lugar de buscar (-autoajuste)
+    string targets_file;  // Bloques cifrados del modo de varios objetivos, vacío si está desactivado
+    bool key_space_given = false;  // Se indicó -k
+    string join_file;  // Puerto de una búsqueda en curso a la que unirse (-unirse), vacío si no
+
+    bool valid_args = argc >= 2;
+    for (int i = 2; i < argc && valid_args; i++) {
+        string option = argv[i];
+        if (option == "-p") {
+            perf_enabled = true;  // Opción sin valor
+            continue;
+        }
+        if (option == "-autoajuste") {
+            auto_tune = true;  // Opción sin valor
+            continue;
+        }
+        if (option == "-texto") {
+            target.text_plain = true;  // Opción sin valor
+            continue;
+        }
+        if (i + 1 >= argc) {
+            valid_args = false;
+            break;
+        }
+        string value = argv[++i];
+        if (option == "-e") {
+            strategy = parseStrategy(value);
+            valid_args = strategy >= 0;
+        } else if (option == "-m") {
+            target.mode = parseMode(value);
+            valid_args = target.mode >= 0;
+        } else if (option == "-iv") {
+            valid_args = value.size() == 16 && value.find_first_not_of("0123456789abcdefABCDEF") == string::npos;
+            for (int j = 0; j < 8 && valid_args; j++) {
+                target.iv[j] = stoi(value.substr(2 * j, 2), nullptr, 16);
+            }
+        } else if (option == "-o") {
+            valid_args = !value.empty() && value.size() <= 18 && value.find_first_not_of("0123456789") == string::npos;
+            target.crib_offset = valid_args ? stoll(value) : -1;
+        } else if (option == "-t") {
+            trace_prefix = value;
+        } else if (option == "-k") {
+            valid_args = parseKeySpace(value, target.space);
+            key_space_given = true;
+        } else if (option == "-des") {
+            des_backend = (value == "openssl") ? DES_OPENSSL : (value == "propio") ? DES_INTERLEAVED : -1;
+            valid_args = des_backend >= 0;
+        } else if (option == "-perfil") {
+            profile_file = value;
+        } else if (option == "-objetivos") {
+            targets_file = value;
+        } else if (option == "-puerto") {
+            join_port_file = value;
+        } else if (option == "-unirse") {
+            join_file = value;
+        } else if (option == "-todas") {
+            find_all_prefix = value;
+        } else if (option == "-c") {
+            target.extra_phrases.push_back(value);  // Se puede repetir
+        } else {
+            valid_args = false;
+        }
+    }
+
+    bool elastic = !join_port_file.empty() || !join_file.empty();
+    if (!targets_file.empty() && !key_space_given) {
+        // Cada rango sabe solo qué objetivos resolvió él, así que la búsqueda no termina al
+        // resolverlos todos: recorre el espacio completo y debe estar acotado
+        if (rank == 0) {
+            cerr << "-objetivos recorre todo el espacio de llaves y requiere acotarlo con -k" << endl;
+        }
+        valid_args = false;
+    } else if (elastic && (strategy != STRATEGY_MASTER || threads > 0 || auto_tune || (!join_port_file.empty() && !join_file.empty()))) {
+        if (rank == 0) {
+            cerr << "-puerto y -unirse requieren MPI y la estrategia maestro, y no se combinan entre sí ni con -autoajuste" << endl;
+        }
+        valid_args = false;
+    } else if (strategy == STRATEGY_MASTER && size < 2 && !elastic) {
+        if (rank == 0) {
+            cerr << "La estrategia maestro requiere al menos 2 procesos" << endl;
+        }
+        valid_args = false;
+    }
+
+    if (!valid_args) {
+        if (rank == 0) {
+            cerr << "Uso: " << argv[0] << " <archivo> [-e bloques|intercalado|maestro|dfs|rma] [-hilos <n>] [-m ecb|cbc|cfb|ofb] [-iv <hex de 16 dígitos>] [-o <posición de la frase>] [-t <prefijo de traza>] [-k <bits fijos>:<bits libres>] [-c <frase adicional>]... [-texto] [-todas <prefijo de salida>] [-objetivos <archivo>] [-des propio|openssl] [-perfil <archivo>] [-autoajuste] [-puerto <archivo> | -unirse <archivo>] [-p]" << endl;
+        }
+        finalizeRuntime(threads);
+        return 1;
+    }
+
+    // Perfil de rendimiento del nodo: cada proceso carga el de su host (o el indicado con -perfil)
+    bool explicit_profile = !profile_file.empty();
+    if (!explicit_profile) {
+        profile_file = defaultProfileName();
+    }
+    if (!auto_tune) {
+        if (loadProfile(profile_file, search_profile)) {
+            cout << "Proceso " << rank << ": perfil " << profile_file << endl;
+        } else if (explicit_profile) {
+            cerr << "No se pudo leer el perfil " << profile_file << endl;
+            finalizeRuntime(threads);
+            return 1;
+        }
+    }
+    if (des_backend < 0) {
+        des_backend = search_profile.des_backend;
+    }
+
+    // Proceso que se une a una búsqueda en curso: toma el rango que le asigna el maestro y
+    // recibe de él el objetivo; se retira limpiamente con SIGTERM, SIGINT o SIGUSR1
+    Transport* joined = nullptr;
+    if (!join_file.empty()) {
+        joined = joinPort(join_file);
+        if (!joined) {
+            cerr << "Proceso " << rank << ": no se pudo unir a la búsqueda de " << join_file << endl;
+            finalizeRuntime(threads);
+            return 1;
+        }
+        rank = joined->rank();
+        cout << "Proceso " << rank << " unido a la búsqueda" << endl;
+        signal(SIGTERM, requestLeave);
+        signal(SIGINT, requestLeave);
+        signal(SIGUSR1, requestLeave);
+    }
+
+    if (rank == 0 && !targets_file.empty()) {
+        // Modo de varios objetivos: el archivo es el texto plano conocido; no hay frase ni llave
+        if (!loadTargets(targets_file, loadText(argv[1]), target)) {
+            finalizeRuntime(threads);
+            return 1;
+        }
+        cout << "Objetivos: " << target.target_blocks.size() << endl;
+        if (target.space.free != UINT64_MAX) {
+            cout << "Espacio de llaves: " << __builtin_popcountll(target.space.free) << " bits libres" << endl;
+        }
+    } else if (rank == 0) {
+        // El rango 0 carga el texto y obtiene la frase clave y la clave de cifrado
+        string filename = argv[1];
+        plain_text = loadText(filename);
+
+        cout << "Ingrese la frase clave a buscar: ";
+        getline(cin, key_phrase);
+
+        cout << "Ingrese una clave numérica para cifrar (0 - 2^64 - 1): ";
+        cin >> key;
+
+        cout << "Llave ingresada " << key << endl;
+
+        if (key == 0) {
+            cerr << "La llave no puede ser 0\n";
+            finalizeRuntime(threads);
+            return 1;
+        }
+
+        if (target.space.free != UINT64_MAX) {
+            cout << "Espacio de llaves: " << __builtin_popcountll(target.space.free) << " bits libres" << endl;
+            if ((key & ~target.space.free) != target.space.fixed) {
+                cerr << "La llave ingresada no coincide con los bits fijos; no se encontrará" << endl;
+            }
+        }
+
+        // Cifrar el texto usando la clave dada
+        encryptText(key, plain_text, cipher_text, target.mode, target.iv);
+
+        if (target.crib_offset >= 0 && target.crib_offset + key_phrase.size() > cipher_text.size()) {
+            cerr << "La frase clave no cabe en la posición indicada; se buscará en todo el texto\n";
+            target.crib_offset = -1;
+        }
+
+        cout << "Texto cifrado: " << cipher_text << endl;
+    }
+    // Difundir el objetivo y el reparto del rango 0 a todos los procesos (con hilos ya se
+    // comparten); un proceso unido los recibe del maestro
+    target.cipher_text = cipher_text;
+    target.key_phrase = key_phrase;
+    if (joined) {
+        uint64_t setup_size;
+        joined->receive(&setup_size, 1, 0, 6);
+        vector<uint64_t> setup(setup_size);
+        joined->receive(setup.data(), setup_size, 0, 6);
+        unpackSearch(setup, target);
+    } else if (threads == 0) {
+        vector<uint64_t> setup;
+        if (rank == 0) {
+            packSearch(target, setup);
+        }
+        uint64_t setup_size = setup.size();
+        MPI_Bcast(&setup_size, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+        setup.resize(setup_size);
+        MPI_Bcast(setup.data(), setup_size, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+        if (rank != 0) {
+            unpackSearch(setup, target);
+        }
+    }
+    if (target.multiTarget()) {
+        target.target_set.build(target.target_blocks);
+    }
+
+    // Elegir el kernel de prueba de llaves según la forma del objetivo
+    string kernel_description;
+    KeyTestKernel kernel = selectKernel(target, des_backend, batch_kernel, kernel_description);
+    if (rank == 0) {
+        cout << "Kernel: " << kernel_description << endl;
+    }
+
+    if (auto_tune) {
+        bool saved = true;
+        runRanks(threads, [&](Transport& transport) {
+            saved = autoTune(transport, target, profile_file) && saved;
+        });
+        finalizeRuntime(threads);
+        return saved ? 0 : 1;
+    }
+
+    trace_enabled = !trace_prefix.empty();
+
+    if (rank == 0) {
+        cout << "Estrategia: " << strategy_names[strategy] << endl;
+    }
+
+    auto search = [&](Transport& transport) {
+        int rank = transport.rank();
+        SearchTarget* thread_target = nullptr;
+        if (threads > 0) {
+            int numa_node;
+            int core = pinToCore(rank, numa_node);
+            if (core >= 0) {
+                cout << "Hilo " << rank << " fijado al núcleo " << core << " (nodo NUMA " << numa_node << ")" << endl;
+            }
+            // Los hilos comparten el objetivo del hilo principal; cada uno lo copia ya fijado
+            // para que el texto cifrado y la tabla de objetivos queden en la memoria de su nodo
+            thread_target = new SearchTarget(target);
+        }
+        const SearchTarget& local_target = thread_target ? *thread_target : target;
+
+        // Origen común de la traza (tras una barrera para alinear los relojes de los procesos;
+        // un proceso unido toma su propio origen)
+        trace_transport = &transport;
+        double trace_origin = 0;
+        if (trace_enabled) {
+            if (!joined) {
+                transport.barrier();
+            }
+            trace_origin = transport.time();
+        }
+
+        // Contadores de hardware del hilo (-p)
+        PerfCounters* counters = perf_enabled ? new PerfCounters() : nullptr;
+        perf_counters = counters;
+
+        // Salida del modo exhaustivo (-todas)
+        KeyWriter* writer = nullptr;
+        if (!find_all_prefix.empty()) {
+            writer = new KeyWriter(find_all_prefix + "." + to_string(rank) + ".bin");
+            if (!writer->ok()) {
+                cerr << "No se pudo crear el archivo " << writer->filename() << endl;
+                transport.abort(1);
+            }
+            key_writer = writer;
+        }
+
+        // Reporte del modo de varios objetivos (-objetivos)
+        TargetReporter* reporter = local_target.multiTarget() ? new TargetReporter(local_target, rank) : nullptr;
+        target_reporter = reporter;
+
+        // Medir el tiempo de la búsqueda
+        double start_time = transport.time();
+        SearchResult result = runStrategy(strategy, transport, local_target, kernel);
+        double elapsed_time = transport.time() - start_time;
+
+        if (counters) {
+            perf_counters = nullptr;
+            if (counters->totals().keys > 0) {
+                reportPerf(rank, *counters);
+            }
+            delete counters;
+        }
+
+        if (reporter) {
+            target_reporter = nullptr;
+            cout << "Proceso " << rank << ": " << reporter->solved() << " objetivos resueltos" << endl;
+            delete reporter;
+        }
+
+        if (writer) {
+            key_writer = nullptr;
+            uint64_t written = writer->close();
+            if (!writer->ok()) {
+                cerr << "Error al escribir " << writer->filename() << endl;
+            }
+            cout << "Proceso " << rank << ": " << written << " llaves en " << writer->filename() << endl;
+            delete writer;
+        }
+
+        delete thread_target;
+
+        if (trace_enabled) {
+            const char* role = (strategy != STRATEGY_MASTER) ? "par" : (rank == 0 ? "maestro" : "esclavo");
+            writeTrace(trace_prefix, rank, role, trace_origin);
+        }
+
+        if (rank == 0) {
+            if (!find_all_prefix.empty() || target.multiTarget()) {
+                cout << "Búsqueda exhaustiva terminada" << endl;
+            } else if (result.found) {
+                // Imprimir la frase clave en lugar de la clave numérica
+                cout << "La clave encontrada es: " << target.key_phrase << endl;
+            } else {
+                cout << "No se encontró la clave." << endl;
+            }
+            cout << "Tiempo total de ejecución: " << fixed << setprecision(2) << elapsed_time << " segundos" << endl;
+
+            if (result.unresponsive_workers > 0) {
+                // Esclavos detenidos impedirían MPI_Finalize; liberar la asignación de inmediato
+                cerr << result.unresponsive_workers << " esclavos no respondieron a la señal de detener" << endl;
+                transport.abort(0);
+            }
+        }
+
+        if (!find_all_prefix.empty() && !joined) {
+            // Unir las salidas de todos los rangos cuando todos cerraron sus archivos (los
+            // procesos unidos cierran el suyo antes de confirmar la señal de detener)
+            transport.barrier();
+            if (rank == 0) {
+                long long merged = mergeKeyFiles(find_all_prefix, transport.size() + result.joined_workers);
+                if (merged >= 0) {
+                    cout << "Llaves que pasan la prueba: " << merged << " (ordenadas en " << find_all_prefix << ".bin)" << endl;
+                }
+            }
+        }
+    };
+
+    if (joined) {
+        search(*joined);
+        delete joined;
+    } else {
+        runRanks(threads, search);
+    }
+
+    finalizeRuntime(threads);
+    return 0;
+}
+
+#endif
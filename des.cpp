@@ -4,8 +4,11 @@ Grupo 4
 
 Parte B inciso 1: DES
 
-g++ -o build/des.o des.cpp -lssl -lcrypto
-./build/des.o
+g++ -O2 -pthread -o build/des.o des.cpp -lssl -lcrypto
+./build/des.o <archivo>
+
+Modo masivo (archivos grandes, varios hilos):
+./build/des.o -cifrar|-descifrar <entrada> <salida> -llave <n> [-m ecb|cbc|cfb|ofb|ctr] [-iv <hex>] [-hilos <n>]
 
 */
 
@@ -25,6 +28,15 @@ g++ -o build/encrypt-text.o encrypt-text.cpp
 #include <fstream>
 #include <iomanip>
 #include <openssl/des.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace std;
 
@@ -107,9 +119,330 @@ string loadText(const string& filename) {
     return text;
 }
 
+enum BulkMode { BULK_ECB, BULK_CBC, BULK_CFB, BULK_OFB, BULK_CTR };
+
+const size_t bulk_chunk_blocks = 1 << 16;  // Bloques por porción de trabajo (512 KiB)
+
+/*
+Estructura BulkJob
+Descripción:
+    Todo lo que necesitan los hilos del modo masivo: la clave preparada, el modo, la dirección
+    y los mapas de entrada y salida. Los hilos leen y escriben directamente en los mapas.
+*/
+struct BulkJob {
+    DES_key_schedule schedule;
+    BulkMode mode;
+    bool encrypt;
+    unsigned char iv[8];
+    const unsigned char* in;
+    unsigned char* out;
+    size_t in_length;
+    size_t out_length;
+};
+
+/*
+Función makeBulkSchedule
+Parámetros:
+    uint64_t key: Llave numérica de 64 bits
+    DES_key_schedule& schedule: Clave preparada
+Descripción:
+    Prepara la llave con el mismo orden de bytes y ajuste de paridad que busqueda.h, para
+    descifrar directamente con la llave que encuentra la búsqueda.
+Retorno:
+    bool: false si la llave es débil
+*/
+bool makeBulkSchedule(uint64_t key, DES_key_schedule& schedule) {
+    DES_cblock key_block;
+    for (int i = 0; i < 8; i++) {
+        key_block[i] = (key >> (56 - 8 * i)) & 0xFF;
+    }
+    DES_set_odd_parity(&key_block);
+    if (DES_is_weak_key(&key_block)) {
+        return false;
+    }
+    return DES_set_key_checked(&key_block, &schedule) == 0;
+}
+
+/*
+Función processBlocks
+Parámetros:
+    const BulkJob& job: Trabajo a procesar
+    size_t first, last: Rango de bloques [first, last)
+Descripción:
+    Cifra o descifra los bloques del rango. ECB y CTR no dependen de otros bloques, y al
+    descifrar CBC y CFB el bloque anterior se lee del texto cifrado de entrada, así que
+    cualquier rango se procesa por separado. El cifrado CBC y CFB y el modo OFB encadenan
+    los bloques y solo se llaman con el rango completo. El último bloque incompleto se
+    rellena con ceros en ECB y CBC; en los modos de flujo la salida mide lo mismo que la entrada.
+Retorno:
+    void
+*/
+void processBlocks(const BulkJob& job, size_t first, size_t last) {
+    DES_key_schedule schedule = job.schedule;  // Copia propia por hilo (OpenSSL no la recibe const)
+    DES_cblock feedback, block, padded, tail;
+    uint64_t counter = 0;
+    for (int i = 0; i < 8; i++) {
+        counter = (counter << 8) | job.iv[i];
+    }
+    counter += first;
+    if (first == 0) {
+        memcpy(feedback, job.iv, 8);
+    } else {
+        memcpy(feedback, job.in + (first - 1) * 8, 8);  // Solo en modos con rangos independientes
+    }
+
+    for (size_t b = first; b < last; b++) {
+        size_t offset = b * 8;
+        const unsigned char* in = job.in + offset;
+        unsigned char* out = job.out + offset;
+        size_t bytes = min((size_t)8, job.in_length - offset);
+        if (bytes < 8) {
+            memset(padded, 0, 8);
+            memcpy(padded, in, bytes);
+            in = padded;
+        }
+        bool partial_out = offset + 8 > job.out_length;
+        if (partial_out) {
+            out = tail;
+        }
+
+        switch (job.mode) {
+            case BULK_CBC:
+                if (job.encrypt) {
+                    for (int j = 0; j < 8; j++) block[j] = in[j] ^ feedback[j];
+                    DES_ecb_encrypt(&block, (DES_cblock*)out, &schedule, DES_ENCRYPT);
+                    memcpy(feedback, out, 8);
+                } else {
+                    DES_ecb_encrypt((const_DES_cblock*)in, &block, &schedule, DES_DECRYPT);
+                    for (int j = 0; j < 8; j++) out[j] = block[j] ^ feedback[j];
+                    memcpy(feedback, in, 8);
+                }
+                break;
+            case BULK_CFB:
+                DES_ecb_encrypt(&feedback, &block, &schedule, DES_ENCRYPT);
+                for (int j = 0; j < 8; j++) out[j] = in[j] ^ block[j];
+                memcpy(feedback, job.encrypt ? out : in, 8);
+                break;
+            case BULK_OFB:
+                DES_ecb_encrypt(&feedback, &block, &schedule, DES_ENCRYPT);
+                memcpy(feedback, block, 8);
+                for (int j = 0; j < 8; j++) out[j] = in[j] ^ block[j];
+                break;
+            case BULK_CTR:
+                for (int j = 0; j < 8; j++) feedback[j] = (counter >> (56 - 8 * j)) & 0xFF;
+                counter++;
+                DES_ecb_encrypt(&feedback, &block, &schedule, DES_ENCRYPT);
+                for (int j = 0; j < 8; j++) out[j] = in[j] ^ block[j];
+                break;
+            default:
+                DES_ecb_encrypt((const_DES_cblock*)in, (DES_cblock*)out, &schedule, job.encrypt ? DES_ENCRYPT : DES_DECRYPT);
+                break;
+        }
+
+        if (partial_out) {
+            memcpy(job.out + offset, tail, job.out_length - offset);
+        }
+    }
+}
+
+/*
+Función bulkProcess
+Parámetros:
+    BulkJob& job: Trabajo con la clave, el modo y la dirección ya listos
+    const string& input, output: Archivos de entrada y salida
+    unsigned& threads: Número de hilos pedido; al volver, el número de hilos realmente usados
+Descripción:
+    Mapea la entrada en memoria, crea la salida con su tamaño final y la mapea también, y
+    reparte porciones de bloques entre los hilos con un contador atómico. No hay copias
+    intermedias: cada hilo lee del mapa de entrada y escribe en el de salida. Los modos que
+    encadenan bloques (cifrado CBC y CFB, OFB) se procesan en un solo hilo, y nunca se crean
+    más hilos que porciones.
+Retorno:
+    bool: true si se completó
+*/
+bool bulkProcess(BulkJob& job, const string& input, const string& output, unsigned& threads) {
+    int in_fd = open(input.c_str(), O_RDONLY);
+    struct stat info;
+    if (in_fd < 0 || fstat(in_fd, &info) != 0) {
+        cerr << "No se pudo abrir el archivo " << input << endl;
+        if (in_fd >= 0) close(in_fd);
+        return false;
+    }
+    job.in_length = info.st_size;
+
+    // Abrir la salida con O_TRUNC borraría la entrada antes de mapearla
+    struct stat out_info;
+    if (stat(output.c_str(), &out_info) == 0 && out_info.st_dev == info.st_dev && out_info.st_ino == info.st_ino) {
+        cerr << "La salida " << output << " es el mismo archivo que la entrada" << endl;
+        close(in_fd);
+        return false;
+    }
+
+    bool block_mode = job.mode == BULK_ECB || job.mode == BULK_CBC;
+    if (block_mode && !job.encrypt && job.in_length % 8 != 0) {
+        cerr << "El texto cifrado en ECB o CBC debe medir un múltiplo de 8 bytes" << endl;
+        close(in_fd);
+        return false;
+    }
+    job.out_length = block_mode ? ((job.in_length + 7) / 8) * 8 : job.in_length;
+
+    int out_fd = open(output.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (out_fd < 0 || ftruncate(out_fd, job.out_length) != 0) {
+        cerr << "No se pudo crear el archivo " << output << endl;
+        close(in_fd);
+        if (out_fd >= 0) close(out_fd);
+        return false;
+    }
+
+    bool ok = true;
+    void* in_map = MAP_FAILED;
+    void* out_map = MAP_FAILED;
+    if (job.in_length > 0) {
+        in_map = mmap(nullptr, job.in_length, PROT_READ, MAP_PRIVATE, in_fd, 0);
+        out_map = mmap(nullptr, job.out_length, PROT_READ | PROT_WRITE, MAP_SHARED, out_fd, 0);
+        if (in_map == MAP_FAILED || out_map == MAP_FAILED) {
+            cerr << "No se pudieron mapear los archivos" << endl;
+            ok = false;
+        }
+    }
+
+    if (job.in_length == 0) {
+        threads = 1;
+    }
+    if (ok && job.in_length > 0) {
+        madvise(in_map, job.in_length, MADV_SEQUENTIAL);
+        job.in = (const unsigned char*)in_map;
+        job.out = (unsigned char*)out_map;
+        size_t blocks = (job.in_length + 7) / 8;
+
+        bool chained = job.mode == BULK_OFB || (job.encrypt && (job.mode == BULK_CBC || job.mode == BULK_CFB));
+        size_t chunks = (blocks + bulk_chunk_blocks - 1) / bulk_chunk_blocks;
+        if (chained || chunks < threads) {
+            threads = chained ? 1 : (unsigned)chunks;
+        }
+        if (threads <= 1) {
+            processBlocks(job, 0, blocks);
+        } else {
+            atomic<size_t> next_chunk(0);
+            vector<thread> workers;
+            for (unsigned t = 0; t < threads; t++) {
+                workers.emplace_back([&] {
+                    for (size_t chunk = next_chunk++; chunk < chunks; chunk = next_chunk++) {
+                        size_t first = chunk * bulk_chunk_blocks;
+                        processBlocks(job, first, min(blocks, first + bulk_chunk_blocks));
+                    }
+                });
+            }
+            for (thread& worker : workers) {
+                worker.join();
+            }
+        }
+    }
+
+    if (in_map != MAP_FAILED) munmap(in_map, job.in_length);
+    if (out_map != MAP_FAILED) munmap(out_map, job.out_length);
+    close(in_fd);
+    close(out_fd);
+    return ok;
+}
+
+/*
+Función runBulk
+Parámetros:
+    int argc, char **argv: Argumentos del programa
+Descripción:
+    Modo masivo: lee las opciones, prepara la llave y procesa el archivo completo con
+    bulkProcess. Informa el tamaño procesado y el rendimiento.
+Retorno:
+    int: Código de salida
+*/
+int runBulk(int argc, char **argv) {
+    if (argc < 4) {
+        cerr << "Uso: " << argv[0] << " -cifrar|-descifrar <entrada> <salida> -llave <n> [-m ecb|cbc|cfb|ofb|ctr] [-iv <hex de 16 dígitos>] [-hilos <n>]" << endl;
+        return 1;
+    }
+
+    BulkJob job = {};
+    job.encrypt = string(argv[1]) == "-cifrar";
+    job.mode = BULK_ECB;
+    string input = argv[2];
+    string output = argv[3];
+    unsigned threads = max(1u, thread::hardware_concurrency());
+    bool has_key = false;
+    uint64_t key = 0;
+
+    // Número completo en la base indicada; false si sobra texto o no cabe
+    auto parseNumber = [](const string& text, int base, uint64_t& number) {
+        size_t used = 0;
+        try {
+            number = stoull(text, &used, base);
+        } catch (const exception&) {
+            return false;
+        }
+        return used == text.size() && text[0] != '-';
+    };
+
+    for (int i = 4; i < argc; i++) {
+        string option = argv[i];
+        string value = (i + 1 < argc) ? argv[i + 1] : "";
+        bool valid = i + 1 < argc;
+        uint64_t number = 0;
+        if (option == "-llave" && valid) {
+            valid = parseNumber(value, 0, key);  // Decimal, como la imprime la búsqueda, o 0x...
+            has_key = true;
+        } else if (option == "-m" && valid) {
+            if (value == "ecb") job.mode = BULK_ECB;
+            else if (value == "cbc") job.mode = BULK_CBC;
+            else if (value == "cfb") job.mode = BULK_CFB;
+            else if (value == "ofb") job.mode = BULK_OFB;
+            else if (value == "ctr") job.mode = BULK_CTR;
+            else valid = false;
+        } else if (option == "-iv" && valid && value.size() == 16 && value.find_first_not_of("0123456789abcdefABCDEF") == string::npos) {
+            for (int j = 0; j < 8 && valid; j++) {
+                valid = parseNumber(value.substr(2 * j, 2), 16, number);
+                job.iv[j] = number;
+            }
+        } else if (option == "-hilos" && valid && parseNumber(value, 10, number) && number > 0 && number <= 4096) {
+            threads = number;
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            cerr << "Opción inválida: " << option << endl;
+            return 1;
+        }
+        i++;
+    }
+
+    if (!has_key) {
+        cerr << "Falta la llave (-llave <n>)" << endl;
+        return 1;
+    }
+    if (!makeBulkSchedule(key, job.schedule)) {
+        cerr << "La clave ingresada es débil. Por favor, ingrese otra clave." << endl;
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+    if (!bulkProcess(job, input, output, threads)) {
+        return 1;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    double megabytes = job.in_length / 1048576.0;
+    cout << (job.encrypt ? "Cifrados " : "Descifrados ") << fixed << setprecision(1) << megabytes << " MB en "
+         << setprecision(3) << seconds << " s (" << setprecision(1) << (seconds > 0 ? megabytes / seconds : 0.0)
+         << " MB/s, " << threads << " hilos)" << endl;
+    return 0;
+}
+
 int main(int argc, char **argv) {
+    if (argc >= 2 && (string(argv[1]) == "-cifrar" || string(argv[1]) == "-descifrar")) {
+        return runBulk(argc, argv);
+    }
+
     if (argc != 2) {
         cerr << "Uso: " << argv[0] << " <archivo>" << endl;
+        cerr << "     " << argv[0] << " -cifrar|-descifrar <entrada> <salida> -llave <n> [-m ecb|cbc|cfb|ofb|ctr] [-iv <hex>] [-hilos <n>]" << endl;
         return 1;
     }
 
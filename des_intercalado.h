@@ -0,0 +1,329 @@
+/*
+Proyecto MPI - DES escalar con varias llaves intercaladas
+Grupo 4
+
+Implementación propia de DES para la búsqueda por fuerza bruta. En lugar de descifrar con
+OpenSSL una llave a la vez, se procesan des_lanes llaves independientes juntas: cada ronda
+se calcula para todas las llaves antes de pasar a la siguiente, de modo que las búsquedas
+en tablas de una llave no esperan a las de otra y el procesador las ejecuta en paralelo.
+
+Las permutaciones (IP, FP, PC1 y PC2) se aplican con tablas por byte (una búsqueda por
+byte de entrada, unidas con OR) y la función de ronda con tablas SP que combinan la caja S
+y la permutación P, alineadas a líneas de caché. Las tablas se generan al iniciar el
+programa a partir de la definición del estándar (FIPS 46-3), y desSelfTest las compara
+con OpenSSL antes de usarlas. Cada hilo fijado a un núcleo usa una copia de las tablas de
+su nodo NUMA (desUseNodeTables), generada por el primer hilo fijado en ese nodo. Numeración de bits del estándar: el bit 1 es el más
+significativo del bloque en orden big-endian.
+*/
+
+#ifndef DES_INTERCALADO_H
+#define DES_INTERCALADO_H
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <openssl/des.h>
+
+const int des_lanes = 4;  // Llaves que se procesan juntas
+
+// Subllaves de una llave en orden de descifrado: 16 rondas de 8 trozos de 6 bits
+struct DesSubkeys {
+    uint8_t k[16][8];
+};
+
+struct DesTables {
+    alignas(64) uint32_t sp[8][64];   // Caja S seguida de la permutación P
+    alignas(64) uint64_t ip[8][256];  // Permutación inicial por byte de entrada
+    alignas(64) uint64_t fp[8][256];  // Permutación final por byte de entrada
+    alignas(64) uint64_t pc1[8][256]; // PC1 (56 bits: C en los bits altos, D en los bajos)
+    alignas(64) uint64_t pc2[7][256]; // PC2 sobre C y D, trozo j de la subllave en el byte j
+
+    DesTables() {
+        static const uint8_t ip_bits[64] = {
+            58, 50, 42, 34, 26, 18, 10, 2, 60, 52, 44, 36, 28, 20, 12, 4,
+            62, 54, 46, 38, 30, 22, 14, 6, 64, 56, 48, 40, 32, 24, 16, 8,
+            57, 49, 41, 33, 25, 17, 9, 1, 59, 51, 43, 35, 27, 19, 11, 3,
+            61, 53, 45, 37, 29, 21, 13, 5, 63, 55, 47, 39, 31, 23, 15, 7};
+        static const uint8_t p_bits[32] = {
+            16, 7, 20, 21, 29, 12, 28, 17, 1, 15, 23, 26, 5, 18, 31, 10,
+            2, 8, 24, 14, 32, 27, 3, 9, 19, 13, 30, 6, 22, 11, 4, 25};
+        static const uint8_t pc1_bits[56] = {
+            57, 49, 41, 33, 25, 17, 9, 1, 58, 50, 42, 34, 26, 18,
+            10, 2, 59, 51, 43, 35, 27, 19, 11, 3, 60, 52, 44, 36,
+            63, 55, 47, 39, 31, 23, 15, 7, 62, 54, 46, 38, 30, 22,
+            14, 6, 61, 53, 45, 37, 29, 21, 13, 5, 28, 20, 12, 4};
+        static const uint8_t pc2_bits[48] = {
+            14, 17, 11, 24, 1, 5, 3, 28, 15, 6, 21, 10,
+            23, 19, 12, 4, 26, 8, 16, 7, 27, 20, 13, 2,
+            41, 52, 31, 37, 47, 55, 30, 40, 51, 45, 33, 48,
+            44, 49, 39, 56, 34, 53, 46, 42, 50, 36, 29, 32};
+        static const uint8_t sbox[8][4][16] = {
+            {{14, 4, 13, 1, 2, 15, 11, 8, 3, 10, 6, 12, 5, 9, 0, 7},
+             {0, 15, 7, 4, 14, 2, 13, 1, 10, 6, 12, 11, 9, 5, 3, 8},
+             {4, 1, 14, 8, 13, 6, 2, 11, 15, 12, 9, 7, 3, 10, 5, 0},
+             {15, 12, 8, 2, 4, 9, 1, 7, 5, 11, 3, 14, 10, 0, 6, 13}},
+            {{15, 1, 8, 14, 6, 11, 3, 4, 9, 7, 2, 13, 12, 0, 5, 10},
+             {3, 13, 4, 7, 15, 2, 8, 14, 12, 0, 1, 10, 6, 9, 11, 5},
+             {0, 14, 7, 11, 10, 4, 13, 1, 5, 8, 12, 6, 9, 3, 2, 15},
+             {13, 8, 10, 1, 3, 15, 4, 2, 11, 6, 7, 12, 0, 5, 14, 9}},
+            {{10, 0, 9, 14, 6, 3, 15, 5, 1, 13, 12, 7, 11, 4, 2, 8},
+             {13, 7, 0, 9, 3, 4, 6, 10, 2, 8, 5, 14, 12, 11, 15, 1},
+             {13, 6, 4, 9, 8, 15, 3, 0, 11, 1, 2, 12, 5, 10, 14, 7},
+             {1, 10, 13, 0, 6, 9, 8, 7, 4, 15, 14, 3, 11, 5, 2, 12}},
+            {{7, 13, 14, 3, 0, 6, 9, 10, 1, 2, 8, 5, 11, 12, 4, 15},
+             {13, 8, 11, 5, 6, 15, 0, 3, 4, 7, 2, 12, 1, 10, 14, 9},
+             {10, 6, 9, 0, 12, 11, 7, 13, 15, 1, 3, 14, 5, 2, 8, 4},
+             {3, 15, 0, 6, 10, 1, 13, 8, 9, 4, 5, 11, 12, 7, 2, 14}},
+            {{2, 12, 4, 1, 7, 10, 11, 6, 8, 5, 3, 15, 13, 0, 14, 9},
+             {14, 11, 2, 12, 4, 7, 13, 1, 5, 0, 15, 10, 3, 9, 8, 6},
+             {4, 2, 1, 11, 10, 13, 7, 8, 15, 9, 12, 5, 6, 3, 0, 14},
+             {11, 8, 12, 7, 1, 14, 2, 13, 6, 15, 0, 9, 10, 4, 5, 3}},
+            {{12, 1, 10, 15, 9, 2, 6, 8, 0, 13, 3, 4, 14, 7, 5, 11},
+             {10, 15, 4, 2, 7, 12, 9, 5, 6, 1, 13, 14, 0, 11, 3, 8},
+             {9, 14, 15, 5, 2, 8, 12, 3, 7, 0, 4, 10, 1, 13, 11, 6},
+             {4, 3, 2, 12, 9, 5, 15, 10, 11, 14, 1, 7, 6, 0, 8, 13}},
+            {{4, 11, 2, 14, 15, 0, 8, 13, 3, 12, 9, 7, 5, 10, 6, 1},
+             {13, 0, 11, 7, 4, 9, 1, 10, 14, 3, 5, 12, 2, 15, 8, 6},
+             {1, 4, 11, 13, 12, 3, 7, 14, 10, 15, 6, 8, 0, 5, 9, 2},
+             {6, 11, 13, 8, 1, 4, 10, 7, 9, 5, 0, 15, 14, 2, 3, 12}},
+            {{13, 2, 8, 4, 6, 15, 11, 1, 10, 9, 3, 14, 5, 0, 12, 7},
+             {1, 15, 13, 8, 10, 3, 7, 4, 12, 5, 6, 11, 0, 14, 9, 2},
+             {7, 11, 4, 1, 9, 12, 14, 2, 0, 6, 10, 13, 15, 3, 5, 8},
+             {2, 1, 14, 7, 4, 10, 8, 13, 15, 12, 9, 0, 3, 5, 6, 11}}};
+
+        // SP: la salida de 4 bits de la caja j ocupa los bits 4j+1..4j+4 antes de P
+        for (int j = 0; j < 8; j++) {
+            for (int v = 0; v < 64; v++) {
+                int row = ((v >> 4) & 2) | (v & 1);
+                int col = (v >> 1) & 15;
+                uint32_t s = (uint32_t)sbox[j][row][col] << (28 - 4 * j);
+                uint32_t out = 0;
+                for (int i = 0; i < 32; i++) {
+                    if (s & (1u << (32 - p_bits[i]))) {
+                        out |= 1u << (31 - i);
+                    }
+                }
+                sp[j][v] = out;
+            }
+        }
+
+        // Inversa de IP
+        uint8_t fp_bits[64];
+        for (int i = 0; i < 64; i++) {
+            fp_bits[ip_bits[i] - 1] = i + 1;
+        }
+
+        byteTable(ip, ip_bits, 64);
+        byteTable(fp, fp_bits, 64);
+        byteTable(pc1, pc1_bits, 56);
+
+        // PC2 sobre los 56 bits de C y D; el bit i de la subllave va al trozo i / 6 (un byte por trozo)
+        for (int b = 0; b < 7; b++) {
+            for (int v = 0; v < 256; v++) {
+                uint64_t out = 0;
+                for (int i = 0; i < 48; i++) {
+                    int bit = pc2_bits[i] - 1;  // Bit de CD, 0 = más significativo
+                    if (bit / 8 == b && (v & (0x80 >> (bit % 8)))) {
+                        out |= (uint64_t)1 << (8 * (i / 6) + 5 - i % 6);
+                    }
+                }
+                pc2[b][v] = out;
+            }
+        }
+    }
+
+private:
+    // Tabla por byte de una permutación de 64 bits a out_width bits (bit 1 = más significativo)
+    static void byteTable(uint64_t (*table)[256], const uint8_t* bits, int out_width) {
+        for (int b = 0; b < 8; b++) {
+            for (int v = 0; v < 256; v++) {
+                uint64_t out = 0;
+                for (int i = 0; i < out_width; i++) {
+                    int bit = bits[i] - 1;
+                    if (bit / 8 == b && (v & (0x80 >> (bit % 8)))) {
+                        out |= (uint64_t)1 << (out_width - 1 - i);
+                    }
+                }
+                table[b][v] = out;
+            }
+        }
+    }
+};
+
+const DesTables des_tables;  // Se generan una vez al iniciar el programa
+
+const int des_max_numa_nodes = 64;
+const DesTables* des_node_tables[des_max_numa_nodes] = {};  // Copia de cada nodo NUMA, nullptr si no se generó
+std::mutex des_node_tables_mutex;
+thread_local const DesTables* des_thread_tables = &des_tables;  // Tablas que usa el hilo
+
+/*
+Función desUseNodeTables
+Parámetros:
+    numa_node: int, nodo NUMA al que está fijado el hilo que llama
+Descripción:
+    Hace que el hilo use la copia de las tablas de su nodo. La primera vez que un hilo de un
+    nodo la pide, la genera él mismo: ya fijado, con la política de primer acceso de Linux la
+    copia queda en la memoria de ese nodo. Las copias duran hasta el fin del programa.
+*/
+inline void desUseNodeTables(int numa_node) {
+    if (numa_node < 0 || numa_node >= des_max_numa_nodes) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(des_node_tables_mutex);
+    if (!des_node_tables[numa_node]) {
+        des_node_tables[numa_node] = new DesTables();
+    }
+    des_thread_tables = des_node_tables[numa_node];
+}
+
+// Aplica una permutación por tablas de byte a los primeros BYTES bytes (desde el más significativo) de value
+template <int BYTES, int WIDTH>
+inline uint64_t desPermute(const uint64_t (*table)[256], uint64_t value) {
+    uint64_t out = 0;
+#pragma GCC unroll 8
+    for (int b = 0; b < BYTES; b++) {
+        out |= table[b][(value >> (WIDTH - 8 - 8 * b)) & 0xFF];
+    }
+    return out;
+}
+
+/*
+Función desSubkeys
+Parámetros:
+    keys: uint64_t[LANES], llaves de 64 bits (big-endian; los bits de paridad se ignoran)
+    out: DesSubkeys[LANES], subllaves en orden de descifrado
+Descripción:
+    Calcula las 16 subllaves de LANES llaves a la vez: PC1, rotaciones de C y D y PC2, con
+    tablas por byte.
+*/
+template <int LANES>
+inline void desSubkeys(const uint64_t* keys, DesSubkeys* out) {
+    static const uint8_t shifts[16] = {1, 1, 2, 2, 2, 2, 2, 2, 1, 2, 2, 2, 2, 2, 2, 1};
+    const uint32_t mask28 = 0x0FFFFFFF;
+    const DesTables& tables = *des_thread_tables;
+
+    uint32_t c[LANES], d[LANES];
+#pragma GCC unroll 8
+    for (int lane = 0; lane < LANES; lane++) {
+        uint64_t cd = desPermute<8, 64>(tables.pc1, keys[lane]);
+        c[lane] = (cd >> 28) & mask28;
+        d[lane] = cd & mask28;
+    }
+#pragma GCC unroll 16
+    for (int round = 0; round < 16; round++) {
+#pragma GCC unroll 8
+        for (int lane = 0; lane < LANES; lane++) {
+            c[lane] = ((c[lane] << shifts[round]) | (c[lane] >> (28 - shifts[round]))) & mask28;
+            d[lane] = ((d[lane] << shifts[round]) | (d[lane] >> (28 - shifts[round]))) & mask28;
+            uint64_t subkey = desPermute<7, 56>(tables.pc2, ((uint64_t)c[lane] << 28) | d[lane]);
+            memcpy(out[lane].k[15 - round], &subkey, 8);  // Trozo j en el byte j (little-endian)
+        }
+    }
+}
+
+// Función de ronda f(R, K) con las tablas SP
+inline uint32_t desRound(const uint32_t (*sp)[64], uint32_t r, const uint8_t* k) {
+    uint32_t x = (r >> 1) | (r << 31);  // E: el bit 32 de R precede al bit 1
+    return sp[0][((x >> 26) ^ k[0]) & 0x3F] | sp[1][((x >> 22) ^ k[1]) & 0x3F] |
+           sp[2][((x >> 18) ^ k[2]) & 0x3F] | sp[3][((x >> 14) ^ k[3]) & 0x3F] |
+           sp[4][((x >> 10) ^ k[4]) & 0x3F] | sp[5][((x >> 6) ^ k[5]) & 0x3F] |
+           sp[6][((x >> 2) ^ k[6]) & 0x3F] | sp[7][(((x << 2) | (x >> 30)) ^ k[7]) & 0x3F];
+}
+
+/*
+Función desLanes
+Parámetros:
+    subkeys: DesSubkeys[LANES], subllaves de cada llave
+    block: uint64_t, bloque de entrada ya permutado con IP (común a todas las llaves)
+    out: uint64_t[LANES], bloque de salida de cada llave (big-endian)
+Descripción:
+    Descifra (o cifra, con las subllaves en orden inverso) el mismo bloque con LANES llaves,
+    ronda por ronda para todas a la vez.
+*/
+template <int LANES, bool DECRYPT>
+inline void desLanes(const DesSubkeys* subkeys, uint64_t block, uint64_t* out) {
+    const DesTables& tables = *des_thread_tables;
+    uint32_t l[LANES], r[LANES];
+#pragma GCC unroll 8
+    for (int lane = 0; lane < LANES; lane++) {
+        l[lane] = block >> 32;
+        r[lane] = (uint32_t)block;
+    }
+#pragma GCC unroll 16
+    for (int round = 0; round < 16; round++) {
+#pragma GCC unroll 8
+        for (int lane = 0; lane < LANES; lane++) {
+            uint32_t next = l[lane] ^ desRound(tables.sp, r[lane], subkeys[lane].k[DECRYPT ? round : 15 - round]);
+            l[lane] = r[lane];
+            r[lane] = next;
+        }
+    }
+#pragma GCC unroll 8
+    for (int lane = 0; lane < LANES; lane++) {
+        out[lane] = desPermute<8, 64>(tables.fp, ((uint64_t)r[lane] << 32) | l[lane]);
+    }
+}
+
+template <int LANES>
+inline void desDecryptLanes(const DesSubkeys* subkeys, uint64_t block, uint64_t* out) {
+    desLanes<LANES, true>(subkeys, block, out);
+}
+
+template <int LANES>
+inline void desEncryptLanes(const DesSubkeys* subkeys, uint64_t block, uint64_t* out) {
+    desLanes<LANES, false>(subkeys, block, out);
+}
+
+// Permutación inicial de un bloque de entrada
+inline uint64_t desInitialPermutation(uint64_t block) {
+    return desPermute<8, 64>(des_thread_tables->ip, block);
+}
+
+/*
+Función desSelfTest
+Descripción:
+    Compara el descifrado y el cifrado propios con DES_ecb_encrypt de OpenSSL para un conjunto
+    de llaves y bloques pseudoaleatorios.
+Retorno:
+    bool, true si todos los resultados coinciden
+*/
+inline bool desSelfTest() {
+    uint64_t state = 0x0123456789ABCDEFULL;
+    for (int test = 0; test < 64; test++) {
+        uint64_t keys[des_lanes];
+        DesSubkeys subkeys[des_lanes];
+        for (int lane = 0; lane < des_lanes; lane++) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            keys[lane] = state;
+        }
+        desSubkeys<des_lanes>(keys, subkeys);
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint64_t block = state;
+
+        uint64_t out[2][des_lanes];
+        desDecryptLanes<des_lanes>(subkeys, desInitialPermutation(block), out[0]);
+        desEncryptLanes<des_lanes>(subkeys, desInitialPermutation(block), out[1]);
+
+        for (int lane = 0; lane < des_lanes; lane++) {
+            DES_cblock key_block, in, expected;
+            for (int i = 0; i < 8; i++) {
+                key_block[i] = (keys[lane] >> (56 - 8 * i)) & 0xFF;
+                in[i] = (block >> (56 - 8 * i)) & 0xFF;
+            }
+            DES_key_schedule schedule;
+            DES_set_key_unchecked(&key_block, &schedule);
+            for (int direction = 0; direction < 2; direction++) {
+                DES_ecb_encrypt(&in, &expected, &schedule, direction == 0 ? DES_DECRYPT : DES_ENCRYPT);
+                for (int i = 0; i < 8; i++) {
+                    if (expected[i] != ((out[direction][lane] >> (56 - 8 * i)) & 0xFF)) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+#endif
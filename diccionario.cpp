@@ -0,0 +1,618 @@
+/*
+Proyecto MPI - Generador de llaves candidatas (diccionario, máscara y reglas)
+Grupo 4
+
+Compilar: mpicxx diccionario.cpp -lcrypto -o build/diccionario.o
+Ejecutar: mpirun -np <n> ./build/diccionario.o <archivo> -w <diccionario.txt> [-r <reglas>] [-d ascii|s2k] [-f texto|crypt|lm]
+          mpirun -np <n> ./build/diccionario.o <archivo> -m <mascara> [-d ascii|s2k] [-f texto|crypt|lm]
+
+Formatos del objetivo (-f):
+    texto: <archivo> es un texto plano que se cifra con la contraseña ingresada (por omisión).
+    crypt: <archivo> contiene un hash crypt(3) DES tradicional de 13 caracteres (sal + 11).
+    lm:    <archivo> contiene un hash LM de 32 dígitos hexadecimales; cada mitad de 7 caracteres
+           se descifra por separado.
+
+Máscara: ?l minúsculas, ?u mayúsculas, ?d dígitos, ?s símbolos, ?a todos, cualquier otro carácter es literal.
+Reglas (separadas por comas): : sin cambio, l minúsculas, u mayúsculas, c capitalizar, r invertir,
+                              d duplicar, $X agregar X al final, ^X agregar X al inicio, sXY reemplazar X por Y.
+*/
+
+#include <iostream>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <openssl/des.h>
+#include <mpi.h>
+#include <vector>
+
+using namespace std;
+
+const uint64_t tamano_lote = 4096;    // Candidatos por lote, los lotes se reparten entre procesos
+const uint64_t intervalo_sondeo = 256; // Cada cuántos candidatos se revisan mensajes
+const size_t largo_resultado = 16;     // Bytes de la contraseña que se reportan (LM: 7 + 7)
+
+/*
+Función derivarLlave
+Parámetros:
+    password: contraseña candidata
+    derivacion: "ascii" (bytes de la contraseña) o "s2k" (DES_string_to_key)
+    key_block: llave DES resultante
+Descripción:
+    Convierte una contraseña en una llave DES.
+*/
+void derivarLlave(const string& password, const string& derivacion, DES_cblock& key_block) {
+    if (derivacion == "s2k") {
+        DES_string_to_key(password.c_str(), &key_block);
+    } else {
+        memset(key_block, 0, sizeof(key_block));
+        memcpy(key_block, password.data(), min<size_t>(8, password.size()));
+    }
+}
+
+/*
+Función encryptText
+Parámetros:
+    key_block: llave DES
+    plain_text: texto a cifrar
+    cipher_text: texto cifrado
+Descripción:
+    Cifra el texto plano con la llave dada en modo ECB.
+*/
+void encryptText(DES_cblock& key_block, const string& plain_text, string& cipher_text) {
+    DES_key_schedule schedule;
+    DES_set_key_unchecked(&key_block, &schedule);
+
+    string padded_plain_text = plain_text;
+    padded_plain_text.resize(((plain_text.size() + 7) / 8) * 8, '\0');
+    cipher_text.resize(padded_plain_text.size());
+
+    for (size_t i = 0; i < padded_plain_text.size(); i += 8) {
+        DES_ecb_encrypt((const_DES_cblock*)(padded_plain_text.data() + i), (DES_cblock*)(cipher_text.data() + i), &schedule, DES_ENCRYPT);
+    }
+}
+
+/*
+Función tryKey
+Parámetros:
+    key_block: llave DES candidata
+    cipher_text: texto cifrado
+    key_phrase: frase clave a buscar
+Retorno:
+    bool, true si el texto descifrado contiene la frase clave
+*/
+bool tryKey(DES_cblock& key_block, const string& cipher_text, const string& key_phrase) {
+    DES_key_schedule schedule;
+    DES_set_key_unchecked(&key_block, &schedule);
+
+    string decrypted_str(cipher_text.size(), '\0');
+    for (size_t i = 0; i < cipher_text.size(); i += 8) {
+        DES_ecb_encrypt((const_DES_cblock*)(cipher_text.data() + i), (DES_cblock*)(&decrypted_str[i]), &schedule, DES_DECRYPT);
+    }
+
+    return decrypted_str.find(key_phrase) != string::npos;
+}
+
+/*
+Función mitadLM
+Parámetros:
+    mitad: hasta 7 caracteres de la contraseña, ya en mayúsculas
+    hash: 8 bytes del hash LM de la mitad (salida)
+Descripción:
+    Expande los 56 bits de la mitad a una llave DES de 8 bytes (7 bits por byte más paridad)
+    y cifra la constante "KGS!@#$%" con ella.
+*/
+void mitadLM(const string& mitad, unsigned char* hash) {
+    static const DES_cblock constante = {'K', 'G', 'S', '!', '@', '#', '$', '%'};
+    unsigned char bytes[7] = {0};
+    memcpy(bytes, mitad.data(), min<size_t>(7, mitad.size()));
+
+    DES_cblock key_block;
+    key_block[0] = bytes[0] >> 1;
+    for (int i = 1; i < 7; i++) {
+        key_block[i] = ((bytes[i - 1] & ((1 << i) - 1)) << (7 - i)) | (bytes[i] >> (i + 1));
+    }
+    key_block[7] = bytes[6] & 0x7F;
+    for (int i = 0; i < 8; i++) {
+        key_block[i] <<= 1;
+    }
+    DES_set_odd_parity(&key_block);
+
+    DES_key_schedule schedule;
+    DES_set_key_unchecked(&key_block, &schedule);
+    DES_ecb_encrypt((const_DES_cblock*)&constante, (DES_cblock*)hash, &schedule, DES_ENCRYPT);
+}
+
+/*
+Función parsearLM
+Parámetros:
+    texto: hash LM en hexadecimal (32 dígitos)
+    hash: 16 bytes del hash (salida)
+Retorno:
+    bool, false si el formato no es válido
+*/
+bool parsearLM(const string& texto, unsigned char* hash) {
+    if (texto.size() != 32 || texto.find_first_not_of("0123456789abcdefABCDEF") != string::npos) {
+        return false;
+    }
+    for (int i = 0; i < 16; i++) {
+        hash[i] = stoi(texto.substr(2 * i, 2), nullptr, 16);
+    }
+    return true;
+}
+
+/*
+Función probarLM
+Parámetros:
+    password: contraseña candidata
+    hash: hash LM objetivo (16 bytes)
+    mitades: mitades del objetivo que coinciden (bit 0 primera, bit 1 segunda) (salida)
+    partes: texto de cada mitad encontrada (salida)
+Descripción:
+    La contraseña se pasa a mayúsculas y se divide en trozos de 7 caracteres (como máximo 14).
+    Como cada mitad del hash depende solo de sus 7 caracteres, cada trozo se compara con
+    ambas mitades del objetivo: una palabra corta puede ser la primera o la segunda mitad.
+*/
+void probarLM(const string& password, const unsigned char* hash, uint64_t& mitades, string* partes) {
+    string mayusculas = password.substr(0, 14);
+    transform(mayusculas.begin(), mayusculas.end(), mayusculas.begin(), ::toupper);
+
+    mitades = 0;
+    for (size_t inicio = 0; inicio < max<size_t>(1, mayusculas.size()); inicio += 7) {
+        string trozo = mayusculas.substr(inicio, 7);
+        unsigned char calculado[8];
+        mitadLM(trozo, calculado);
+        for (int mitad = 0; mitad < 2; mitad++) {
+            if (memcmp(calculado, hash + 8 * mitad, 8) == 0) {
+                mitades |= 1ULL << mitad;
+                partes[mitad] = trozo;
+            }
+        }
+    }
+}
+
+/*
+Función loadText
+Parámetros:
+    filename: nombre del archivo a cargar
+Retorno:
+    contenido del archivo
+*/
+string loadText(const string& filename) {
+    ifstream file(filename);
+
+    if (!file.is_open()) {
+        cerr << "No se pudo abrir el archivo " << filename << endl;
+        return "";
+    }
+
+    string text((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    file.close();
+
+    return text;
+}
+
+/*
+Función parsearMascara
+Parámetros:
+    mascara: máscara con marcadores ?l ?u ?d ?s ?a y literales
+Descripción:
+    Convierte la máscara en un conjunto de caracteres por posición.
+Retorno:
+    vector<string>, caracteres posibles para cada posición
+*/
+vector<string> parsearMascara(const string& mascara) {
+    const string minusculas = "abcdefghijklmnopqrstuvwxyz";
+    const string mayusculas = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    const string digitos = "0123456789";
+    const string simbolos = " !\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~";
+
+    vector<string> posiciones;
+    for (size_t i = 0; i < mascara.size(); i++) {
+        if (mascara[i] == '?' && i + 1 < mascara.size()) {
+            switch (mascara[++i]) {
+                case 'l': posiciones.push_back(minusculas); break;
+                case 'u': posiciones.push_back(mayusculas); break;
+                case 'd': posiciones.push_back(digitos); break;
+                case 's': posiciones.push_back(simbolos); break;
+                case 'a': posiciones.push_back(minusculas + mayusculas + digitos + simbolos); break;
+                default:  posiciones.push_back(string(1, mascara[i])); break;
+            }
+        } else {
+            posiciones.push_back(string(1, mascara[i]));
+        }
+    }
+    return posiciones;
+}
+
+/*
+Función candidatoMascara
+Parámetros:
+    posiciones: conjuntos de caracteres por posición
+    indice: índice del candidato dentro del espacio de la máscara
+Descripción:
+    Decodifica el índice en base mixta; la última posición varía más rápido.
+Retorno:
+    string, contraseña candidata
+*/
+string candidatoMascara(const vector<string>& posiciones, uint64_t indice) {
+    string password(posiciones.size(), '\0');
+    for (size_t i = posiciones.size(); i-- > 0;) {
+        password[i] = posiciones[i][indice % posiciones[i].size()];
+        indice /= posiciones[i].size();
+    }
+    return password;
+}
+
+/*
+Función aplicarRegla
+Parámetros:
+    palabra: palabra del diccionario
+    regla: secuencia de operaciones
+Retorno:
+    string, palabra transformada
+*/
+string aplicarRegla(const string& palabra, const string& regla) {
+    string resultado = palabra;
+    for (size_t i = 0; i < regla.size(); i++) {
+        switch (regla[i]) {
+            case 'l':
+                transform(resultado.begin(), resultado.end(), resultado.begin(), ::tolower);
+                break;
+            case 'u':
+                transform(resultado.begin(), resultado.end(), resultado.begin(), ::toupper);
+                break;
+            case 'c':
+                transform(resultado.begin(), resultado.end(), resultado.begin(), ::tolower);
+                if (!resultado.empty()) {
+                    resultado[0] = toupper(resultado[0]);
+                }
+                break;
+            case 'r':
+                reverse(resultado.begin(), resultado.end());
+                break;
+            case 'd':
+                resultado += resultado;
+                break;
+            case '$':
+                if (i + 1 < regla.size()) {
+                    resultado += regla[++i];
+                }
+                break;
+            case '^':
+                if (i + 1 < regla.size()) {
+                    resultado.insert(resultado.begin(), regla[++i]);
+                }
+                break;
+            case 's':
+                if (i + 2 < regla.size()) {
+                    replace(resultado.begin(), resultado.end(), regla[i + 1], regla[i + 2]);
+                    i += 2;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return resultado;
+}
+
+/*
+Función revisarMensajes
+Parámetros:
+    encontrados: objetivos ya resueltos (bits); se agregan los que avisen otros procesos
+    found_key: llave recibida si otro proceso la encontró
+Retorno:
+    bool, true si llegó algún aviso
+*/
+bool revisarMensajes(uint64_t& encontrados, uint64_t& found_key) {
+    int flag;
+    MPI_Status status;
+    MPI_Iprobe(MPI_ANY_SOURCE, 0, MPI_COMM_WORLD, &flag, &status);
+    if (flag) {
+        uint64_t aviso[2];
+        MPI_Recv(aviso, 2, MPI_UINT64_T, status.MPI_SOURCE, 0, MPI_COMM_WORLD, &status);
+        encontrados |= aviso[0];
+        found_key = aviso[1];
+        return true;
+    }
+    return false;
+}
+
+/*
+Función avisarEncontrada
+Parámetros:
+    objetivos: bits de los objetivos resueltos (la mitad del hash LM, o 1 para texto y crypt)
+    found_key: llave encontrada (formato texto)
+Descripción:
+    Comunica lo encontrado a los demás procesos.
+*/
+void avisarEncontrada(uint64_t objetivos, uint64_t found_key, int rank, int size) {
+    uint64_t aviso[2] = {objetivos, found_key};
+    for (int proc = 0; proc < size; proc++) {
+        if (proc != rank) {
+            MPI_Send(aviso, 2, MPI_UINT64_T, proc, 0, MPI_COMM_WORLD);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    MPI_Init(&argc, &argv);
+
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    string diccionario, mascara, derivacion = "ascii", formato = "texto";
+    vector<string> reglas = {":"};
+
+    bool argumentos_validos = argc >= 4;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        string opcion = argv[i];
+        if (opcion == "-w") {
+            diccionario = argv[i + 1];
+        } else if (opcion == "-m") {
+            mascara = argv[i + 1];
+        } else if (opcion == "-d") {
+            derivacion = argv[i + 1];
+        } else if (opcion == "-f") {
+            formato = argv[i + 1];
+        } else if (opcion == "-r") {
+            reglas.clear();
+            stringstream lista(argv[i + 1]);
+            string regla;
+            while (getline(lista, regla, ',')) {
+                reglas.push_back(regla);
+            }
+        } else {
+            argumentos_validos = false;
+        }
+    }
+    if (argc % 2 != 0 || diccionario.empty() == mascara.empty() || (derivacion != "ascii" && derivacion != "s2k") ||
+        (formato != "texto" && formato != "crypt" && formato != "lm")) {
+        argumentos_validos = false;
+    }
+
+    if (!argumentos_validos) {
+        if (rank == 0) {
+            cerr << "Uso: " << argv[0] << " <archivo> -w <diccionario.txt> [-r <reglas>] [-d ascii|s2k] [-f texto|crypt|lm]" << endl;
+            cerr << "     " << argv[0] << " <archivo> -m <mascara> [-d ascii|s2k] [-f texto|crypt|lm]" << endl;
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    string key_phrase;
+    string cipher_text;  // Texto cifrado (texto) o hash objetivo (crypt, lm)
+
+    if (rank == 0 && formato != "texto") {
+        // El archivo contiene el hash en la primera línea
+        stringstream contenido(loadText(argv[1]));
+        getline(contenido, cipher_text);
+        cipher_text.erase(cipher_text.find_last_not_of(" \t\r") + 1);
+        cout << "Hash objetivo (" << formato << "): " << cipher_text << endl;
+    } else if (rank == 0) {
+        string plain_text = loadText(argv[1]);
+
+        cout << "Ingrese la frase clave a buscar: ";
+        getline(cin, key_phrase);
+
+        string password;
+        cout << "Ingrese la contraseña para cifrar: ";
+        getline(cin, password);
+
+        DES_cblock key_block;
+        derivarLlave(password, derivacion, key_block);
+        encryptText(key_block, plain_text, cipher_text);
+
+        cout << "Texto cifrado: " << cipher_text << endl;
+    }
+
+    // Enviar la frase clave y el texto cifrado a todos los procesos
+    int phrase_length = key_phrase.size();
+    MPI_Bcast(&phrase_length, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    key_phrase.resize(phrase_length);
+    MPI_Bcast(&key_phrase[0], phrase_length, MPI_CHAR, 0, MPI_COMM_WORLD);
+
+    int cipher_length = cipher_text.size();
+    MPI_Bcast(&cipher_length, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    cipher_text.resize(cipher_length);
+    MPI_Bcast(&cipher_text[0], cipher_length, MPI_CHAR, 0, MPI_COMM_WORLD);
+
+    // Objetivos a resolver: un bit por texto/hash, o uno por cada mitad del hash LM
+    uint64_t necesarios = 1;
+    unsigned char hash_lm[16];
+    bool objetivo_valido = true;
+    if (formato == "lm") {
+        objetivo_valido = parsearLM(cipher_text, hash_lm);
+        necesarios = 3;
+    } else if (formato == "crypt") {
+        objetivo_valido = cipher_text.size() == 13;
+    }
+
+    if (!objetivo_valido) {
+        if (rank == 0) {
+            cerr << "Hash " << formato << " no válido: " << cipher_text << endl;
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    double start_time = MPI_Wtime();
+
+    bool found = false;
+    uint64_t encontrados = 0;
+    uint64_t found_key = 0;
+    uint64_t probados = 0;
+    char resultado_texto[largo_resultado] = {0};  // Contraseña encontrada por este proceso (crypt, lm)
+
+    // Registra objetivos resueltos por este proceso y avisa a los demás
+    auto registrar = [&](uint64_t objetivos) {
+        encontrados |= objetivos;
+        found = encontrados == necesarios;
+        avisarEncontrada(objetivos, found_key, rank, size);
+    };
+
+    // Probar un candidato; devuelve true si se debe detener la búsqueda
+    auto probarCandidato = [&](const string& password) {
+        ++probados;
+        if (formato == "crypt") {
+            // crypt(3): 25 iteraciones de DES sobre un bloque de ceros con la sal del hash
+            char salida[14];
+            DES_fcrypt(password.c_str(), cipher_text.c_str(), salida);
+            if (cipher_text == salida) {
+                strncpy(resultado_texto, password.c_str(), 8);
+                cout << "Proceso " << rank << " encontró la contraseña: \"" << password.substr(0, 8) << "\"\n";
+                registrar(1);
+                return true;
+            }
+        } else if (formato == "lm") {
+            uint64_t mitades;
+            string partes[2];
+            probarLM(password, hash_lm, mitades, partes);
+            mitades &= ~encontrados;
+            if (mitades) {
+                for (int mitad = 0; mitad < 2; mitad++) {
+                    if (mitades & (1ULL << mitad)) {
+                        memcpy(resultado_texto + 7 * mitad, partes[mitad].data(), partes[mitad].size());
+                        cout << "Proceso " << rank << " encontró la mitad " << mitad + 1 << " del hash LM: \"" << partes[mitad] << "\"\n";
+                    }
+                }
+                registrar(mitades);
+                if (found) {
+                    return true;
+                }
+            }
+        } else {
+            DES_cblock key_block;
+            derivarLlave(password, derivacion, key_block);
+
+            if (tryKey(key_block, cipher_text, key_phrase)) {
+                memcpy(&found_key, key_block, sizeof(found_key));
+                cout << "Proceso " << rank << " encontró la contraseña: \"" << password << "\"\n";
+                registrar(1);
+                return true;
+            }
+        }
+
+        if (probados % intervalo_sondeo == 0 && revisarMensajes(encontrados, found_key)) {
+            found = encontrados == necesarios;
+            return found;
+        }
+        return false;
+    };
+
+    // La segunda mitad de un hash LM de una contraseña de hasta 7 caracteres es la de una mitad vacía
+    if (formato == "lm") {
+        string partes[2];
+        probarLM("", hash_lm, encontrados, partes);
+        if (encontrados == necesarios && rank == 0) {
+            cout << "El hash LM corresponde a la contraseña vacía" << endl;
+        }
+        found = encontrados == necesarios;
+    }
+
+    if (!mascara.empty()) {
+        // Espacio de la máscara: los lotes se asignan a los procesos en forma cíclica
+        vector<string> posiciones = parsearMascara(mascara);
+        // El recorrido por lotes suma hasta tamano_lote * size más allá del total
+        uint64_t limite = UINT64_MAX - tamano_lote * size;
+        uint64_t total = 1;
+        for (const string& conjunto : posiciones) {
+            if (total > limite / conjunto.size()) {
+                // Todos los procesos calculan lo mismo y salen juntos
+                if (rank == 0) {
+                    cerr << "La máscara " << mascara << " tiene demasiados candidatos" << endl;
+                }
+                MPI_Finalize();
+                return 1;
+            }
+            total *= conjunto.size();
+        }
+
+        if (rank == 0) {
+            cout << "Candidatos en la máscara: " << total << endl;
+        }
+
+        for (uint64_t lote = rank * tamano_lote; lote < total && !found; lote += tamano_lote * size) {
+            uint64_t fin = min(total, lote + tamano_lote);
+            for (uint64_t i = lote; i < fin; i++) {
+                if (probarCandidato(candidatoMascara(posiciones, i))) {
+                    break;
+                }
+            }
+        }
+    } else {
+        // Diccionario: cada proceso toma los lotes de líneas que le corresponden
+        ifstream archivo(diccionario);
+        int abierto = archivo.is_open() ? 1 : 0;
+        int todos_abiertos = 0;
+        MPI_Allreduce(&abierto, &todos_abiertos, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+        if (!todos_abiertos) {
+            // Si algún proceso no puede leer el diccionario, su parte quedaría sin revisar
+            if (!abierto) {
+                cerr << "Proceso " << rank << ": no se pudo abrir el archivo " << diccionario << endl;
+            }
+            MPI_Finalize();
+            return 1;
+        }
+
+        string palabra;
+        for (uint64_t linea = 0; !found && getline(archivo, palabra); linea++) {
+            if ((linea / tamano_lote) % size != (uint64_t)rank) {
+                continue;
+            }
+            if (!palabra.empty() && palabra.back() == '\r') {
+                palabra.pop_back();
+            }
+            for (const string& regla : reglas) {
+                if (probarCandidato(aplicarRegla(palabra, regla))) {
+                    break;
+                }
+            }
+        }
+    }
+
+    // Todos los procesos terminan su parte o reciben el aviso; acordar el resultado
+    uint64_t resultado = found ? found_key : 0;
+    uint64_t global_key = 0;
+    uint64_t global_encontrados = 0;
+    uint64_t total_probados = 0;
+    char global_texto[largo_resultado];
+    MPI_Allreduce(&resultado, &global_key, 1, MPI_UINT64_T, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Reduce(&encontrados, &global_encontrados, 1, MPI_UINT64_T, MPI_BOR, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&probados, &total_probados, 1, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+    // Cada mitad la aporta quien la encontró; las demás quedan en cero.
+    // MPI_MAX no está definido para MPI_CHAR, así que se reducen como bytes sin signo
+    MPI_Reduce(resultado_texto, global_texto, largo_resultado, MPI_UNSIGNED_CHAR, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    // Descartar avisos que llegaron después de terminar
+    uint64_t descartado_bits, descartado;
+    while (revisarMensajes(descartado_bits, descartado)) {
+    }
+
+    double elapsed_time = MPI_Wtime() - start_time;
+
+    if (rank == 0) {
+        if (formato != "texto") {
+            if (global_encontrados == necesarios) {
+                string password(global_texto, strnlen(global_texto, largo_resultado));
+                cout << "Contraseña del hash: \"" << password << "\"" << endl;
+            } else if (global_encontrados != 0) {
+                cout << "Solo se encontró una mitad del hash LM" << endl;
+            } else {
+                cout << "Ningún candidato corresponde al hash." << endl;
+            }
+        } else if (global_key != 0) {
+            cout << "Llave encontrada: " << global_key << endl;
+        } else {
+            cout << "Ningún candidato descifra el texto." << endl;
+        }
+        cout << "Candidatos probados: " << total_probados << endl;
+        cout << "Tiempo total de ejecución: " << fixed << setprecision(4) << elapsed_time << " segundos\n";
+    }
+
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,451 @@
+/*
+Proyecto MPI - Búsqueda sin frase clave con puntuación estadística del texto
+Grupo 4
+
+Compilar: mpicxx puntuacion.cpp -lcrypto -o build/puntuacion.o  (con -mavx2 las consultas al modelo son vectoriales)
+Ejecutar: mpirun -np <n> ./build/puntuacion.o <archivo> <llave_inicio> <llave_fin> [-n <mejores>] [-c <corpus.txt>]
+
+En lugar de buscar una frase clave, cada llave candidata descifra el texto y se puntúa con un
+modelo de lenguaje de bytes y bigramas (log-probabilidades precalculadas). Se recorre todo el
+rango [llave_inicio, llave_fin) y se reportan las N llaves con mejor puntuación.
+*/
+
+#include <iostream>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <cmath>
+#include <algorithm>
+#include <queue>
+#include <stdexcept>
+#include <openssl/des.h>
+#include <mpi.h>
+#include <vector>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// Texto de entrenamiento por defecto si no se indica un corpus
+const char* default_corpus =
+    "El proyecto consiste en encontrar la llave privada con la que fue cifrado un texto plano. "
+    "La busqueda se hace probando todas las posibles combinaciones de llaves, hasta encontrar una "
+    "que descifra el texto. Los procesos se reparten el trabajo y se comunican cuando alguno encuentra "
+    "la respuesta correcta, de modo que todos pueden detenerse al mismo tiempo. "
+    "The quick brown fox jumps over the lazy dog. This is a sample of ordinary English text that "
+    "contains the most common letters, words and punctuation, so that the model learns which pairs "
+    "of characters are frequent in natural language and which ones almost never appear together.\n";
+
+const int score_scale = 16;        // Las log-probabilidades se guardan como enteros (log2 * 16)
+const int threshold_sigmas = 4;    // Margen del umbral de rechazo del primer bloque
+
+// Modelo de lenguaje: puntuación de cada byte y de cada par de bytes consecutivos
+struct LanguageModel {
+    vector<int32_t> byte_score;     // 256 entradas
+    vector<int32_t> bigram_score;   // 256 * 256 entradas, índice (anterior << 8) | actual
+    int32_t block_threshold;        // Puntuación mínima de un bloque de texto natural
+    int32_t max_block_score;        // Cota superior de la puntuación de un bloque
+};
+
+// Candidato del ranking
+struct ScoredKey {
+    int64_t score;
+    uint64_t key;
+    bool operator>(const ScoredKey& other) const { return score > other.score; }
+};
+
+/*
+Función makeKeySchedule
+Parámetros:
+    key_num: uint64_t, clave numérica de 64 bits
+    schedule: DES_key_schedule, resultado
+Descripción:
+    Convierte la clave numérica en DES_cblock con el orden de bytes correcto, ajusta la paridad
+    y descarta las claves débiles.
+Retorno:
+    bool, false si la clave es débil o no se pudo establecer
+*/
+bool makeKeySchedule(uint64_t key_num, DES_key_schedule& schedule) {
+    DES_cblock key_block;
+
+    for (int i = 0; i < 8; i++) {
+        key_block[i] = (key_num >> (56 - 8 * i)) & 0xFF;
+    }
+
+    DES_set_odd_parity(&key_block);
+
+    if (DES_is_weak_key(&key_block)) {
+        return false;
+    }
+
+    return DES_set_key_checked(&key_block, &schedule) == 0;
+}
+
+/*
+Función encryptText
+Parámetros:
+    key_num: uint64_t, clave numérica de 64 bits
+    plain_text: string, texto a cifrar
+    cipher_text: string, texto cifrado
+Retorno:
+    bool, false si la clave es débil
+*/
+bool encryptText(uint64_t key_num, const string& plain_text, string& cipher_text) {
+    DES_key_schedule schedule;
+    if (!makeKeySchedule(key_num, schedule)) {
+        return false;
+    }
+
+    string padded_plain_text = plain_text;
+    padded_plain_text.resize(((plain_text.size() + 7) / 8) * 8, '\0');
+    cipher_text.resize(padded_plain_text.size());
+
+    for (size_t i = 0; i < padded_plain_text.size(); i += 8) {
+        DES_ecb_encrypt((const_DES_cblock*)(padded_plain_text.data() + i), (DES_cblock*)(&cipher_text[i]), &schedule, DES_ENCRYPT);
+    }
+    return true;
+}
+
+/*
+Función loadText
+Parámetros:
+    filename: string, nombre del archivo a cargar
+Retorno:
+    string, contenido del archivo
+*/
+string loadText(const string& filename) {
+    ifstream file(filename);
+
+    if (!file.is_open()) {
+        cerr << "No se pudo abrir el archivo " << filename << endl;
+        return "";
+    }
+
+    string text((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    file.close();
+
+    return text;
+}
+
+/*
+Función scoreBlock
+Parámetros:
+    model: LanguageModel, modelo de lenguaje
+    block: 8 bytes descifrados
+    previous: byte anterior al bloque (-1 si es el primero)
+Descripción:
+    Suma las puntuaciones de bytes y bigramas del bloque. Con AVX2 las 8 consultas de bytes y
+    las 8 de bigramas son dos gathers de 8 carriles (el bigrama con el byte anterior se enmascara
+    en el primer bloque); sin AVX2 las 15 consultas son independientes entre sí y se acumulan
+    por separado para que se ejecuten en paralelo.
+Retorno:
+    int64_t, puntuación del bloque
+*/
+inline int64_t scoreBlock(const LanguageModel& model, const unsigned char* block, int previous) {
+    const int32_t* bytes = model.byte_score.data();
+    const int32_t* bigrams = model.bigram_score.data();
+
+#ifdef __AVX2__
+    uint64_t word;
+    memcpy(&word, block, 8);
+    __m256i current = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(word));
+    // Byte anterior de cada carril: el bloque desplazado un byte, con previous en el carril 0
+    __m256i before = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128((word << 8) | (previous & 0xFF)));
+    __m256i pairs = _mm256_or_si256(_mm256_slli_epi32(before, 8), current);
+    __m256i first_lane = _mm256_setr_epi32(previous >= 0 ? -1 : 0, -1, -1, -1, -1, -1, -1, -1);
+
+    __m256i sum = _mm256_add_epi32(_mm256_i32gather_epi32(bytes, current, 4),
+                                   _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), bigrams, pairs, first_lane, 4));
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+    return _mm_cvtsi128_si32(half);
+#else
+
+    int64_t byte_sum = bytes[block[0]] + bytes[block[1]] + bytes[block[2]] + bytes[block[3]] +
+                       bytes[block[4]] + bytes[block[5]] + bytes[block[6]] + bytes[block[7]];
+    int64_t bigram_sum = bigrams[(block[0] << 8) | block[1]] + bigrams[(block[1] << 8) | block[2]] +
+                         bigrams[(block[2] << 8) | block[3]] + bigrams[(block[3] << 8) | block[4]] +
+                         bigrams[(block[4] << 8) | block[5]] + bigrams[(block[5] << 8) | block[6]] +
+                         bigrams[(block[6] << 8) | block[7]];
+    if (previous >= 0) {
+        bigram_sum += bigrams[(previous << 8) | block[0]];
+    }
+    return byte_sum + bigram_sum;
+#endif
+}
+
+/*
+Función buildModel
+Parámetros:
+    corpus: string, texto de entrenamiento
+Descripción:
+    Calcula log-probabilidades con suavizado de Laplace y el umbral de rechazo del primer
+    bloque a partir de la media y desviación de los bloques del corpus.
+Retorno:
+    LanguageModel, modelo entrenado
+*/
+LanguageModel buildModel(const string& corpus) {
+    vector<double> byte_count(256, 1.0);
+    vector<double> bigram_count(256 * 256, 1.0);
+    vector<double> row_total(256, 256.0);
+
+    for (size_t i = 0; i < corpus.size(); i++) {
+        unsigned char current = corpus[i];
+        byte_count[current] += 1;
+        if (i > 0) {
+            unsigned char previous = corpus[i - 1];
+            bigram_count[(previous << 8) | current] += 1;
+            row_total[previous] += 1;
+        }
+    }
+
+    LanguageModel model;
+    model.byte_score.resize(256);
+    model.bigram_score.resize(256 * 256);
+
+    double byte_total = corpus.size() + 256.0;
+    for (int b = 0; b < 256; b++) {
+        model.byte_score[b] = lround(score_scale * log2(byte_count[b] / byte_total));
+    }
+    for (int p = 0; p < 256; p++) {
+        for (int c = 0; c < 256; c++) {
+            // Información mutua puntual: byte + bigrama = log2 P(actual | anterior)
+            double conditional = bigram_count[(p << 8) | c] / row_total[p];
+            double marginal = byte_count[c] / byte_total;
+            model.bigram_score[(p << 8) | c] = lround(score_scale * log2(conditional / marginal));
+        }
+    }
+
+    // Umbral: media menos threshold_sigmas desviaciones de los bloques de texto natural
+    vector<double> scores;
+    for (size_t i = 0; i + 8 <= corpus.size(); i += 8) {
+        scores.push_back(scoreBlock(model, (const unsigned char*)corpus.data() + i, -1));
+    }
+    double mean = 0, variance = 0;
+    for (double score : scores) {
+        mean += score;
+    }
+    mean /= max<size_t>(1, scores.size());
+    for (double score : scores) {
+        variance += (score - mean) * (score - mean);
+    }
+    variance /= max<size_t>(1, scores.size());
+    model.block_threshold = lround(mean - threshold_sigmas * sqrt(variance));
+
+    int32_t max_byte = *max_element(model.byte_score.begin(), model.byte_score.end());
+    int32_t max_bigram = *max_element(model.bigram_score.begin(), model.bigram_score.end());
+    model.max_block_score = 8 * max_byte + 8 * max_bigram;
+
+    return model;
+}
+
+/*
+Función scoreKey
+Parámetros:
+    key_num: uint64_t, clave candidata
+    cipher_text: string, texto cifrado
+    model: LanguageModel, modelo de lenguaje
+    cutoff: int64_t, puntuación que debe superar para entrar al ranking
+    score: int64_t, puntuación obtenida
+Descripción:
+    Descifra bloque a bloque y acumula la puntuación. Se rechaza tras el primer bloque si no
+    parece texto natural, y en cualquier bloque si ni con la puntuación máxima en los restantes
+    alcanzaría el corte del ranking.
+Retorno:
+    bool, true si la llave entra al ranking
+*/
+bool scoreKey(uint64_t key_num, const string& cipher_text, const LanguageModel& model, int64_t cutoff, int64_t& score) {
+    DES_key_schedule schedule;
+    if (!makeKeySchedule(key_num, schedule)) {
+        return false;
+    }
+
+    size_t blocks = cipher_text.size() / 8;
+    DES_cblock decrypted;
+    int previous = -1;
+    score = 0;
+
+    for (size_t b = 0; b < blocks; b++) {
+        DES_ecb_encrypt((const_DES_cblock*)(cipher_text.data() + b * 8), &decrypted, &schedule, DES_DECRYPT);
+        int64_t block_score = scoreBlock(model, decrypted, previous);
+        score += block_score;
+        previous = decrypted[7];
+
+        if (b == 0 && block_score < model.block_threshold) {
+            return false;
+        }
+        if (score + (int64_t)(blocks - b - 1) * model.max_block_score <= cutoff) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+Función preview
+Descripción:
+    Descifra el inicio del texto con la llave dada, reemplazando los bytes no imprimibles.
+*/
+string preview(uint64_t key_num, const string& cipher_text, size_t length) {
+    DES_key_schedule schedule;
+    if (!makeKeySchedule(key_num, schedule)) {
+        return "";
+    }
+
+    string text;
+    for (size_t i = 0; i < cipher_text.size() && text.size() < length; i += 8) {
+        DES_cblock decrypted;
+        DES_ecb_encrypt((const_DES_cblock*)(cipher_text.data() + i), &decrypted, &schedule, DES_DECRYPT);
+        for (int j = 0; j < 8; j++) {
+            text += isprint(decrypted[j]) ? (char)decrypted[j] : '.';
+        }
+    }
+    return text.substr(0, length);
+}
+
+/*
+Función parseKey
+Parámetros:
+    text: string, llave en decimal
+    key: uint64_t, valor leído
+Retorno:
+    bool, true si el texto es un entero sin signo que cabe en 64 bits
+*/
+bool parseKey(const string& text, uint64_t& key) {
+    if (text.empty() || text.find_first_not_of("0123456789") != string::npos) {
+        return false;
+    }
+    try {
+        key = stoull(text);
+    } catch (const out_of_range&) {
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    MPI_Init(&argc, &argv);
+
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    int top_n = 10;
+    string corpus_file;
+    uint64_t range_start = 0;
+    uint64_t range_end = 0;
+    // El rango debe ser no vacío: con fin <= inicio el total de llaves se desbordaría
+    bool valid_args = argc >= 4 && argc % 2 == 0 &&
+                      parseKey(argv[2], range_start) && parseKey(argv[3], range_end) &&
+                      range_end > range_start;
+    for (int i = 4; i + 1 < argc && valid_args; i += 2) {
+        string option = argv[i];
+        if (option == "-n") {
+            top_n = max(1, atoi(argv[i + 1]));
+        } else if (option == "-c") {
+            corpus_file = argv[i + 1];
+        } else {
+            valid_args = false;
+        }
+    }
+
+    if (!valid_args) {
+        if (rank == 0) {
+            cerr << "Uso: " << argv[0] << " <archivo> <llave_inicio> <llave_fin> [-n <mejores>] [-c <corpus.txt>]" << endl;
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    string cipher_text;
+
+    if (rank == 0) {
+        string plain_text = loadText(argv[1]);
+
+        uint64_t key;
+        cout << "Ingrese una clave numérica para cifrar (0 - 2^64 - 1): ";
+        cin >> key;
+
+        if (!encryptText(key, plain_text, cipher_text)) {
+            cerr << "La clave ingresada es débil. Por favor, ingrese otra clave." << endl;
+            cipher_text.clear();
+        }
+    }
+
+    int cipher_length = cipher_text.size();
+    MPI_Bcast(&cipher_length, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (cipher_length == 0) {
+        MPI_Finalize();
+        return 1;
+    }
+    cipher_text.resize(cipher_length);
+    MPI_Bcast(&cipher_text[0], cipher_length, MPI_CHAR, 0, MPI_COMM_WORLD);
+
+    // Cada proceso entrena el mismo modelo localmente (tablas en su propia memoria)
+    string corpus = corpus_file.empty() ? string(default_corpus) : loadText(corpus_file);
+    int has_corpus = corpus.size() >= 8 ? 1 : 0;  // Al menos un bloque para calcular el umbral
+    int all_have_corpus = 0;
+    MPI_Allreduce(&has_corpus, &all_have_corpus, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    if (!all_have_corpus) {
+        if (!has_corpus) {
+            cerr << "Proceso " << rank << ": el corpus " << corpus_file << " no existe o está vacío" << endl;
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    LanguageModel model = buildModel(corpus);
+
+    double start_time = MPI_Wtime();
+
+    // Reparto del rango en bloques iguales
+    uint64_t total = range_end - range_start;
+    uint64_t my_start = range_start + total / size * rank;
+    uint64_t my_end = (rank == size - 1) ? range_end : my_start + total / size;
+
+    // Ranking local: montículo de mínimos con las mejores top_n llaves
+    priority_queue<ScoredKey, vector<ScoredKey>, greater<ScoredKey>> best;
+    int64_t cutoff = INT64_MIN;
+
+    for (uint64_t i = my_start; i < my_end; i++) {
+        int64_t score;
+        if (scoreKey(i, cipher_text, model, cutoff, score)) {
+            best.push({score, i});
+            if ((int)best.size() > top_n) {
+                best.pop();
+            }
+            if ((int)best.size() == top_n) {
+                cutoff = best.top().score;
+            }
+        }
+    }
+
+    // Reunir los rankings locales en el proceso 0
+    vector<ScoredKey> local;
+    while (!best.empty()) {
+        local.push_back(best.top());
+        best.pop();
+    }
+    local.resize(top_n, {INT64_MIN, 0});
+
+    vector<ScoredKey> all(rank == 0 ? top_n * size : 0);
+    MPI_Gather(local.data(), top_n * 2, MPI_INT64_T, all.data(), top_n * 2, MPI_INT64_T, 0, MPI_COMM_WORLD);
+
+    double elapsed_time = MPI_Wtime() - start_time;
+
+    if (rank == 0) {
+        sort(all.begin(), all.end(), greater<ScoredKey>());
+        cout << "Mejores llaves en [" << range_start << ", " << range_end << "):" << endl;
+        for (int i = 0; i < top_n && all[i].score != INT64_MIN; i++) {
+            cout << setw(3) << i + 1 << ". llave " << all[i].key << "  puntuación " << fixed << setprecision(2)
+                 << (double)all[i].score / score_scale / cipher_text.size() << " bits/byte  -> "
+                 << preview(all[i].key, cipher_text, 40) << endl;
+        }
+        cout << "Tiempo total de ejecución: " << fixed << setprecision(4) << elapsed_time << " segundos\n";
+    }
+
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,445 @@
+/*
+Proyecto MPI - Tablas Rainbow para DES con texto plano elegido
+Grupo 4
+
+Compilar: mpicxx rainbow.cpp -lcrypto -o build/rainbow.o
+Generar:  mpirun -np <n> ./build/rainbow.o generar <tabla.bin> <texto_plano> <num_cadenas> <largo_cadena> [bits] [id_tabla]
+Buscar:   mpirun -np <n> ./build/rainbow.o buscar <cifrado_hex> <tabla.bin> [<tabla.bin> ...]
+Cifrar:   ./build/rainbow.o cifrar <texto_plano> <llave>
+*/
+
+#include <iostream>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <openssl/des.h>
+#include <mpi.h>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+const uint64_t MAGIA_TABLA = 0x3142544E49415252ULL;  // "RRAINTB1"
+
+// Encabezado del archivo de la tabla, seguido de num_cadenas entradas ordenadas por fin
+struct EncabezadoTabla {
+    uint64_t magia;
+    uint64_t num_cadenas;
+    uint64_t largo_cadena;
+    uint64_t bits;
+    uint64_t id_tabla;
+    uint8_t texto_plano[8];
+};
+
+struct Cadena {
+    uint64_t fin;
+    uint64_t inicio;
+};
+
+/*
+Función expandirLlave
+Parámetros:
+    indice: índice de 56 bits (o menos) dentro del espacio de llaves
+    key_block: bloque de llave DES resultante
+Descripción:
+    Reparte los 56 bits efectivos del índice en los 7 bits altos de cada byte de la llave,
+    dejando libre el bit de paridad. Así índices distintos producen llaves DES distintas.
+*/
+void expandirLlave(uint64_t indice, DES_cblock& key_block) {
+    for (int i = 7; i >= 0; i--) {
+        key_block[i] = (indice & 0x7F) << 1;
+        indice >>= 7;
+    }
+}
+
+/*
+Función cifrarBloque
+Parámetros:
+    indice: índice de la llave
+    texto_plano: bloque de 8 bytes a cifrar
+Descripción:
+    Cifra un único bloque con la llave correspondiente al índice.
+Retorno:
+    uint64_t, bloque cifrado interpretado en big-endian
+*/
+uint64_t cifrarBloque(uint64_t indice, const uint8_t texto_plano[8]) {
+    DES_cblock key_block;
+    DES_key_schedule schedule;
+    DES_cblock salida;
+
+    expandirLlave(indice, key_block);
+    DES_set_key_unchecked(&key_block, &schedule);
+    DES_ecb_encrypt((const_DES_cblock*)texto_plano, &salida, &schedule, DES_ENCRYPT);
+
+    uint64_t bloque = 0;
+    for (int i = 0; i < 8; i++) {
+        bloque = (bloque << 8) | salida[i];
+    }
+    return bloque;
+}
+
+/*
+Función reducir
+Parámetros:
+    bloque: bloque cifrado
+    posicion: posición dentro de la cadena
+    id_tabla: identificador de la tabla
+    mascara: máscara del espacio de llaves
+Descripción:
+    Función de reducción de la cadena. Depende de la posición para evitar
+    que las cadenas se fusionen y del id de tabla para que tablas distintas sean independientes.
+Retorno:
+    uint64_t, siguiente índice de llave
+*/
+inline uint64_t reducir(uint64_t bloque, uint64_t posicion, uint64_t id_tabla, uint64_t mascara) {
+    uint64_t mezcla = (posicion + (id_tabla << 32)) * 0x9E3779B97F4A7C15ULL;
+    return (bloque ^ mezcla) & mascara;
+}
+
+/*
+Función recorrerCadena
+Parámetros:
+    indice: índice inicial
+    desde, hasta: posiciones de la cadena a recorrer [desde, hasta)
+    encabezado: parámetros de la tabla
+Descripción:
+    Avanza la cadena aplicando cifrado y reducción.
+Retorno:
+    uint64_t, índice alcanzado en la posición hasta
+*/
+uint64_t recorrerCadena(uint64_t indice, uint64_t desde, uint64_t hasta, const EncabezadoTabla& encabezado) {
+    uint64_t mascara = (encabezado.bits >= 64) ? UINT64_MAX : ((1ULL << encabezado.bits) - 1);
+    for (uint64_t j = desde; j < hasta; j++) {
+        indice = reducir(cifrarBloque(indice, encabezado.texto_plano), j, encabezado.id_tabla, mascara);
+    }
+    return indice;
+}
+
+/*
+Función prepararTextoPlano
+Parámetros:
+    texto: texto plano elegido
+    bloque: bloque de 8 bytes resultante
+Descripción:
+    Toma los primeros 8 bytes del texto, rellenando con ceros.
+*/
+void prepararTextoPlano(const string& texto, uint8_t bloque[8]) {
+    memset(bloque, 0, 8);
+    memcpy(bloque, texto.data(), min<size_t>(8, texto.size()));
+}
+
+/*
+Función leerHex
+Parámetros:
+    hex: bloque en hexadecimal (16 dígitos)
+    bloque: valor resultante
+Retorno:
+    bool, true si el formato es válido
+*/
+bool leerHex(const string& hex, uint64_t& bloque) {
+    if (hex.size() != 16 || hex.find_first_not_of("0123456789abcdefABCDEF") != string::npos) {
+        return false;
+    }
+    bloque = stoull(hex, nullptr, 16);
+    return true;
+}
+
+/*
+Función leerNumero
+Parámetros:
+    texto: número decimal sin signo
+    valor: valor resultante
+Retorno:
+    bool, true si el texto es un número válido que cabe en 64 bits
+*/
+bool leerNumero(const string& texto, uint64_t& valor) {
+    if (texto.empty() || texto.find_first_not_of("0123456789") != string::npos) {
+        return false;
+    }
+    try {
+        valor = stoull(texto);
+    } catch (const out_of_range&) {
+        return false;
+    }
+    return true;
+}
+
+/*
+Función generarTabla
+Descripción:
+    Cada proceso calcula una parte de las cadenas. El proceso 0 las reúne,
+    ordena por punto final, descarta finales repetidos y escribe la tabla.
+*/
+int generarTabla(int rank, int size, const string& archivo, const EncabezadoTabla& encabezado) {
+    uint64_t mascara = (encabezado.bits >= 64) ? UINT64_MAX : ((1ULL << encabezado.bits) - 1);
+
+    // Reparto por bloques de las cadenas entre procesos
+    uint64_t por_proceso = encabezado.num_cadenas / size;
+    uint64_t primera = por_proceso * rank + min<uint64_t>(rank, encabezado.num_cadenas % size);
+    uint64_t cantidad = por_proceso + (rank < (int)(encabezado.num_cadenas % size) ? 1 : 0);
+
+    vector<Cadena> cadenas(cantidad);
+    for (uint64_t i = 0; i < cantidad; i++) {
+        // Puntos iniciales dispersos en el espacio de llaves
+        uint64_t inicio = ((primera + i) * 0xD6E8FEB86659FD93ULL) & mascara;
+        cadenas[i].inicio = inicio;
+        cadenas[i].fin = recorrerCadena(inicio, 0, encabezado.largo_cadena, encabezado);
+
+        if (rank == 0 && i % 100000 == 0 && i > 0) {
+            cout << "Proceso 0: " << i << " de " << cantidad << " cadenas" << endl;
+        }
+    }
+
+    // Reunir las cadenas en el proceso 0 (cada cadena son 2 uint64_t)
+    int cuenta = cantidad * 2;
+    vector<int> cuentas(size), desplazamientos(size);
+    MPI_Gather(&cuenta, 1, MPI_INT, cuentas.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    vector<Cadena> todas;
+    if (rank == 0) {
+        int total = 0;
+        for (int i = 0; i < size; i++) {
+            desplazamientos[i] = total;
+            total += cuentas[i];
+        }
+        todas.resize(total / 2);
+    }
+    MPI_Gatherv(cadenas.data(), cuenta, MPI_UINT64_T, todas.data(), cuentas.data(), desplazamientos.data(), MPI_UINT64_T, 0, MPI_COMM_WORLD);
+
+    if (rank != 0) {
+        return 0;
+    }
+
+    sort(todas.begin(), todas.end(), [](const Cadena& a, const Cadena& b) { return a.fin < b.fin; });
+    todas.erase(unique(todas.begin(), todas.end(), [](const Cadena& a, const Cadena& b) { return a.fin == b.fin; }), todas.end());
+
+    EncabezadoTabla final_encabezado = encabezado;
+    final_encabezado.num_cadenas = todas.size();
+
+    ofstream salida(archivo, ios::binary);
+    if (!salida.is_open()) {
+        cerr << "No se pudo crear el archivo " << archivo << endl;
+        return 1;
+    }
+    salida.write((const char*)&final_encabezado, sizeof(final_encabezado));
+    salida.write((const char*)todas.data(), todas.size() * sizeof(Cadena));
+    salida.close();
+
+    cout << "Tabla escrita en " << archivo << ": " << todas.size() << " cadenas únicas de "
+         << encabezado.num_cadenas << " generadas" << endl;
+    return 0;
+}
+
+/*
+Función buscarEnTabla
+Parámetros:
+    archivo: tabla a consultar (se mapea en memoria)
+    objetivo: bloque cifrado a invertir
+    rank, size: posiciones de la cadena que revisa este proceso (intercaladas)
+    llave: llave encontrada
+Retorno:
+    bool, true si se encontró una llave que cifra el texto plano al objetivo
+*/
+bool buscarEnTabla(const string& archivo, uint64_t objetivo, int rank, int size, uint64_t& llave) {
+    int fd = open(archivo.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cerr << "No se pudo abrir el archivo " << archivo << endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        cerr << "No se pudo leer el tamaño del archivo " << archivo << endl;
+        close(fd);
+        return false;
+    }
+    if ((size_t)info.st_size < sizeof(EncabezadoTabla)) {
+        cerr << "Tabla inválida: " << archivo << endl;
+        close(fd);
+        return false;
+    }
+
+    void* mapa = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED) {
+        cerr << "No se pudo mapear el archivo " << archivo << endl;
+        return false;
+    }
+
+    const EncabezadoTabla& encabezado = *(const EncabezadoTabla*)mapa;
+    const Cadena* cadenas = (const Cadena*)((const char*)mapa + sizeof(EncabezadoTabla));
+    const Cadena* fin_cadenas = cadenas + encabezado.num_cadenas;
+
+    // Se compara por división para que un num_cadenas corrupto no desborde el producto
+    size_t max_cadenas = ((size_t)info.st_size - sizeof(EncabezadoTabla)) / sizeof(Cadena);
+    if (encabezado.magia != MAGIA_TABLA || encabezado.num_cadenas > max_cadenas ||
+        sizeof(EncabezadoTabla) + encabezado.num_cadenas * sizeof(Cadena) != (size_t)info.st_size) {
+        cerr << "Tabla inválida: " << archivo << endl;
+        munmap(mapa, info.st_size);
+        return false;
+    }
+
+    uint64_t mascara = (encabezado.bits >= 64) ? UINT64_MAX : ((1ULL << encabezado.bits) - 1);
+    uint64_t t = encabezado.largo_cadena;
+    bool encontrada = false;
+
+    // Suponer que el objetivo aparece en la posición p de alguna cadena
+    for (uint64_t p = t - 1 - rank; p < t && !encontrada; p -= size) {
+        uint64_t candidato = reducir(objetivo, p, encabezado.id_tabla, mascara);
+        candidato = recorrerCadena(candidato, p + 1, t, encabezado);
+
+        const Cadena* it = lower_bound(cadenas, fin_cadenas, candidato,
+                                       [](const Cadena& c, uint64_t valor) { return c.fin < valor; });
+
+        if (it != fin_cadenas && it->fin == candidato) {
+            // Reconstruir la cadena desde el inicio hasta la posición p
+            uint64_t indice = recorrerCadena(it->inicio, 0, p, encabezado);
+
+            // Descartar falsas alarmas
+            if (cifrarBloque(indice, encabezado.texto_plano) == objetivo) {
+                llave = indice;
+                encontrada = true;
+            }
+        }
+
+        if (p < (uint64_t)size) {
+            break;
+        }
+    }
+
+    munmap(mapa, info.st_size);
+    return encontrada;
+}
+
+int main(int argc, char **argv) {
+    MPI_Init(&argc, &argv);
+
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    string modo = (argc > 1) ? argv[1] : "";
+
+    if (modo == "cifrar" && argc == 4) {
+        // Utilidad para producir un objetivo de prueba
+        uint64_t llave;
+        if (!leerNumero(argv[3], llave)) {
+            if (rank == 0) {
+                cerr << "Llave inválida: " << argv[3] << endl;
+            }
+            MPI_Finalize();
+            return 1;
+        }
+        if (rank == 0) {
+            uint8_t texto_plano[8];
+            prepararTextoPlano(argv[2], texto_plano);
+            cout << hex << setw(16) << setfill('0') << cifrarBloque(llave, texto_plano) << endl;
+        }
+        MPI_Finalize();
+        return 0;
+    }
+
+    if (modo == "generar" && argc >= 6 && argc <= 8) {
+        EncabezadoTabla encabezado = {};
+        encabezado.magia = MAGIA_TABLA;
+        encabezado.bits = 56;
+        encabezado.id_tabla = 0;
+        if (!leerNumero(argv[4], encabezado.num_cadenas) ||
+            !leerNumero(argv[5], encabezado.largo_cadena) ||
+            (argc > 6 && !leerNumero(argv[6], encabezado.bits)) ||
+            (argc > 7 && !leerNumero(argv[7], encabezado.id_tabla))) {
+            if (rank == 0) {
+                cerr << "Parámetros inválidos: cadenas, largo, bits e id deben ser enteros sin signo" << endl;
+            }
+            MPI_Finalize();
+            return 1;
+        }
+        prepararTextoPlano(argv[3], encabezado.texto_plano);
+
+        if (encabezado.bits == 0 || encabezado.bits > 56 || encabezado.largo_cadena == 0) {
+            if (rank == 0) {
+                cerr << "Parámetros inválidos: bits debe estar en [1, 56] y el largo de cadena ser mayor que 0" << endl;
+            }
+            MPI_Finalize();
+            return 1;
+        }
+
+        // Las cuentas y desplazamientos de MPI_Gatherv son int: la tabla completa
+        // (2 uint64_t por cadena) debe caber en INT_MAX elementos
+        if (encabezado.num_cadenas == 0 || encabezado.num_cadenas > (uint64_t)INT_MAX / 2) {
+            if (rank == 0) {
+                cerr << "Parámetros inválidos: el número de cadenas debe estar en [1, " << INT_MAX / 2 << "]" << endl;
+            }
+            MPI_Finalize();
+            return 1;
+        }
+
+        double start_time = MPI_Wtime();
+        int resultado = generarTabla(rank, size, argv[2], encabezado);
+        double elapsed_time = MPI_Wtime() - start_time;
+
+        if (rank == 0) {
+            cout << "Tiempo de generación: " << fixed << setprecision(4) << elapsed_time << " segundos\n";
+        }
+        MPI_Finalize();
+        return resultado;
+    }
+
+    if (modo == "buscar" && argc >= 4) {
+        uint64_t objetivo;
+        if (!leerHex(argv[2], objetivo)) {
+            if (rank == 0) {
+                cerr << "El bloque cifrado debe tener 16 dígitos hexadecimales" << endl;
+            }
+            MPI_Finalize();
+            return 1;
+        }
+
+        double start_time = MPI_Wtime();
+        uint64_t found_key = UINT64_MAX;
+
+        for (int i = 3; i < argc && found_key == UINT64_MAX; i++) {
+            uint64_t llave;
+            uint64_t local = UINT64_MAX;
+            if (buscarEnTabla(argv[i], objetivo, rank, size, llave)) {
+                cout << "Proceso " << rank << " encontró la llave: " << llave << " en " << argv[i] << "\n";
+                local = llave;
+            }
+            MPI_Allreduce(&local, &found_key, 1, MPI_UINT64_T, MPI_MIN, MPI_COMM_WORLD);
+        }
+
+        double elapsed_time = MPI_Wtime() - start_time;
+
+        if (rank == 0) {
+            if (found_key != UINT64_MAX) {
+                DES_cblock key_block;
+                expandirLlave(found_key, key_block);
+                cout << "Llave encontrada: " << found_key << " (DES: ";
+                for (int i = 0; i < 8; i++) {
+                    cout << hex << setw(2) << setfill('0') << (int)key_block[i];
+                }
+                cout << dec << ")\n";
+            } else {
+                cout << "La llave no está cubierta por las tablas.\n";
+            }
+            cout << "Tiempo de búsqueda: " << fixed << setprecision(4) << elapsed_time << " segundos\n";
+        }
+        MPI_Finalize();
+        return 0;
+    }
+
+    if (rank == 0) {
+        cerr << "Uso: " << argv[0] << " generar <tabla.bin> <texto_plano> <num_cadenas> <largo_cadena> [bits] [id_tabla]" << endl;
+        cerr << "     " << argv[0] << " buscar <cifrado_hex> <tabla.bin> [<tabla.bin> ...]" << endl;
+        cerr << "     " << argv[0] << " cifrar <texto_plano> <llave>" << endl;
+    }
+    MPI_Finalize();
+    return 1;
+}
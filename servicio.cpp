@@ -0,0 +1,706 @@
+/*
+Proyecto MPI - Servicio persistente de búsqueda con varios trabajos y prioridades
+Grupo 4
+
+Compilar: mpicxx -O2 servicio.cpp -lcrypto -o build/servicio.o
+Ejecutar: mpirun -np <num_procesos> ./build/servicio.o <directorio_spool> [-des propio|openssl] [-perfil <archivo>]
+
+Cada trabajo es un archivo <nombre>.trabajo en el directorio spool con líneas clave=valor:
+    prioridad=<n>          mayor número = más urgente (por defecto 0)
+    frase=<frase clave>
+    cifrado=<hex>          texto cifrado en hexadecimal
+  o bien, para pruebas:
+    archivo=<texto plano>  y  llave=<clave numérica>, el servicio cifra el texto al cargarlo
+  opcionales:
+    modo=ecb|cbc|cfb|ofb   modo de operación (por defecto ecb), con iv=<hex de 16 dígitos>
+    posicion=<n>           posición conocida de la frase en el texto plano
+    bits=<fijos>:<libres>  bits conocidos de la llave, como -k de busqueda.o
+    inicio=<n>, fin=<n>    rango de índices del espacio de llaves, ambos incluidos (sin bits=,
+                           el índice es la propia llave)
+
+Los esclavos prueban las llaves con los kernels de busqueda.h (elegidos por trabajo según el
+modo, la forma del objetivo y el DES del perfil del nodo) y confirman los candidatos con el
+verificador. Cada unidad entregada es un arrendamiento: si el esclavo no la confirma a tiempo,
+se entrega a otro. El resultado se escribe en <nombre>.resultado y el progreso en
+<nombre>.estado, de modo que un trabajo interrumpido se reanuda al reiniciar el servicio. Un
+trabajo inválido se descarta con el motivo en <nombre>.resultado (error=...). Crear el
+archivo <spool>/detener termina el servicio; el maestro lo borra al atenderlo para que el
+siguiente arranque no se detenga de inmediato.
+*/
+
+#include "busqueda.h"
+#include <climits>
+#include <set>
+#include <memory>
+#include <dirent.h>
+
+const double spool_scan_interval = 1.0;  // Segundos entre revisiones del directorio spool
+const double job_lease_timeout = 60.0;   // Segundos antes de reasignar una unidad sin confirmar
+const uint64_t no_job = UINT64_MAX;
+
+// Etiquetas de los mensajes
+const int TAG_REQUEST = 0;   // esclavo -> maestro: {trabajo, inicio} de la unidad terminada
+const int TAG_UNIT = 1;      // maestro -> esclavo: {trabajo, inicio, fin}
+const int TAG_RESULT = 2;    // esclavo -> maestro: {trabajo, llave}
+const int TAG_CANCEL = 3;    // maestro -> esclavo: {trabajo} ya terminado, abandonarlo
+const int TAG_JOB = 5;       // maestro -> esclavo: {trabajo, objetivo empaquetado con packSearch}
+const int TAG_SHUTDOWN = 6;  // maestro -> esclavo: terminar el servicio
+
+// Estado de un trabajo en el maestro (los rangos son de índices del espacio de llaves)
+struct Job {
+    string name;
+    int priority;
+    SearchTarget target;
+    uint64_t next_key;              // Siguiente índice por entregar
+    uint64_t end_key;               // Último índice del trabajo (incluido)
+    bool keys_exhausted;            // Ya se entregó end_key
+    map<uint64_t, Lease> outstanding;  // Unidades entregadas y no terminadas, por inicio
+    uint64_t last_grant;            // Para repartir en ronda entre trabajos de igual prioridad
+};
+
+// Trabajo conocido por un esclavo: objetivo, kernels elegidos y su verificador de candidatos
+struct WorkerJob {
+    SearchTarget target;
+    KeyTestKernel kernel;
+    KeyBatchKernel batch;
+    unique_ptr<CandidateVerifier> verifier;  // Después de target: se destruye antes
+};
+
+/*
+Función fileExists
+Retorno:
+    bool, true si el archivo existe
+*/
+bool fileExists(const string& filename) {
+    return access(filename.c_str(), F_OK) == 0;
+}
+
+/*
+Función parseUnsigned
+Parámetros:
+    text: string, valor de un campo
+    value: uint64_t, resultado
+Retorno:
+    bool, false si el texto no es un número decimal completo o no cabe en 64 bits
+*/
+bool parseUnsigned(const string& text, uint64_t& value) {
+    if (text.empty() || text.find_first_not_of("0123456789") != string::npos) {
+        return false;
+    }
+    try {
+        value = stoull(text);
+    } catch (const out_of_range&) {
+        return false;
+    }
+    return true;
+}
+
+/*
+Función loadJob
+Parámetros:
+    spool: string, directorio spool
+    name: string, nombre del trabajo (sin extensión)
+    job: Job, trabajo cargado
+    error: string, motivo si la definición no es válida (salida)
+Descripción:
+    Lee la definición del trabajo y, si existe, el progreso guardado en <nombre>.estado.
+    Ningún campo mal escrito detiene al servicio: se informa como error del trabajo.
+Retorno:
+    bool, true si la definición es válida
+*/
+bool loadJob(const string& spool, const string& name, Job& job, string& error) {
+    ifstream file(spool + "/" + name + ".trabajo");
+    if (!file.is_open()) {
+        error = "no se pudo leer la definición";
+        return false;
+    }
+
+    map<string, string> fields;
+    string line;
+    while (getline(file, line)) {
+        size_t equals = line.find('=');
+        if (equals != string::npos) {
+            fields[line.substr(0, equals)] = line.substr(equals + 1);
+        }
+    }
+
+    job.name = name;
+    job.priority = 0;
+    job.last_grant = 0;
+    job.keys_exhausted = false;
+
+    SearchTarget& target = job.target;
+    target.key_phrase = fields["frase"];
+    target.mode = MODE_ECB;
+    memset(target.iv, 0, sizeof(target.iv));
+    target.crib_offset = -1;
+    if (target.key_phrase.empty()) {
+        error = "falta la frase";
+        return false;
+    }
+
+    uint64_t value;
+    if (fields.count("prioridad")) {
+        const string& priority = fields["prioridad"];
+        bool negative = !priority.empty() && priority[0] == '-';
+        if (!parseUnsigned(priority.substr(negative ? 1 : 0), value) || value > INT_MAX) {
+            error = "prioridad inválida";
+            return false;
+        }
+        job.priority = negative ? -(int)value : (int)value;
+    }
+    if (fields.count("modo")) {
+        target.mode = parseMode(fields["modo"]);
+        if (target.mode < 0) {
+            error = "modo inválido";
+            return false;
+        }
+    }
+    if (fields.count("iv")) {
+        const string& iv = fields["iv"];
+        if (iv.size() != 16 || iv.find_first_not_of("0123456789abcdefABCDEF") != string::npos) {
+            error = "iv inválido";
+            return false;
+        }
+        for (int j = 0; j < 8; j++) {
+            target.iv[j] = stoi(iv.substr(2 * j, 2), nullptr, 16);
+        }
+    }
+    if (fields.count("bits") && !parseKeySpace(fields["bits"], target.space)) {
+        error = "bits inválidos";
+        return false;
+    }
+
+    if (fields.count("cifrado")) {
+        const string& hex = fields["cifrado"];
+        if (hex.empty() || hex.size() % 16 != 0 || hex.find_first_not_of("0123456789abcdefABCDEF") != string::npos) {
+            error = "cifrado inválido";
+            return false;
+        }
+        for (size_t i = 0; i < hex.size(); i += 2) {
+            target.cipher_text.push_back((char)stoi(hex.substr(i, 2), nullptr, 16));
+        }
+    } else if (fields.count("archivo") && fields.count("llave")) {
+        DES_key_schedule schedule;
+        if (!parseUnsigned(fields["llave"], value) || !makeKeySchedule(value, schedule)) {
+            error = "llave inválida o débil";
+            return false;
+        }
+        string plain_text = loadText(fields["archivo"]);
+        if (plain_text.empty()) {
+            error = "no se pudo leer " + fields["archivo"];
+            return false;
+        }
+        encryptText(value, plain_text, target.cipher_text, target.mode, target.iv);
+    } else {
+        error = "falta cifrado= o archivo= y llave=";
+        return false;
+    }
+
+    if (fields.count("posicion")) {
+        if (!parseUnsigned(fields["posicion"], value) || target.key_phrase.size() > target.cipher_text.size() ||
+            value > target.cipher_text.size() - target.key_phrase.size()) {
+            error = "posición inválida";
+            return false;
+        }
+        target.crib_offset = value;
+    }
+
+    // Rango de índices, ambos extremos incluidos
+    job.next_key = 0;
+    job.end_key = target.space.last;
+    if ((fields.count("inicio") && !parseUnsigned(fields["inicio"], job.next_key)) ||
+        (fields.count("fin") && !parseUnsigned(fields["fin"], job.end_key))) {
+        error = "rango inválido";
+        return false;
+    }
+    if (job.next_key > job.end_key || job.end_key > target.space.last) {
+        error = "rango inválido: inicio > fin o fin fuera del espacio de llaves";
+        return false;
+    }
+
+    // Reanudar desde el progreso guardado (se ignora si no está dentro del rango)
+    ifstream state(spool + "/" + name + ".estado");
+    string saved;
+    if (state >> saved && parseUnsigned(saved, value) && value >= job.next_key && value <= job.end_key) {
+        job.next_key = value;
+    }
+
+    return true;
+}
+
+/*
+Función saveProgress
+Descripción:
+    Guarda el primer índice que aún no se revisó con certeza: el inicio de la unidad
+    pendiente más baja o, si no hay pendientes, el siguiente índice por entregar.
+*/
+void saveProgress(const string& spool, const Job& job) {
+    if (job.keys_exhausted && job.outstanding.empty()) {
+        return;
+    }
+    uint64_t safe_key = job.outstanding.empty() ? job.next_key : job.outstanding.begin()->first;
+    ofstream state(spool + "/" + job.name + ".estado");
+    state << safe_key << endl;
+}
+
+/*
+Función finishJob
+Descripción:
+    Escribe el resultado del trabajo y borra su progreso guardado.
+*/
+void finishJob(const string& spool, const Job& job, bool found, uint64_t key, double elapsed_time) {
+    ofstream result(spool + "/" + job.name + ".resultado");
+    if (found) {
+        result << "llave=" << key << endl;
+    } else {
+        result << "llave=no encontrada" << endl;
+    }
+    result << "tiempo=" << fixed << setprecision(2) << elapsed_time << endl;
+    result.close();
+    unlink((spool + "/" + job.name + ".estado").c_str());
+
+    cout << "Trabajo " << job.name << " terminado: " << (found ? to_string(key) : "no encontrada") << endl;
+}
+
+/*
+Función rejectJob
+Descripción:
+    Descarta un trabajo inválido: escribe el motivo en su resultado, así no se vuelve a
+    cargar al reiniciar el servicio.
+*/
+void rejectJob(const string& spool, const string& name, const string& error) {
+    ofstream result(spool + "/" + name + ".resultado");
+    result << "error=" << error << endl;
+    result.close();
+    cerr << "Trabajo inválido: " << name << " (" << error << ")" << endl;
+}
+
+/*
+Función scanSpool
+Parámetros:
+    spool: string, directorio spool
+    known: set<string>, trabajos ya cargados o descartados
+Retorno:
+    vector<string>, nombres de trabajos nuevos sin resultado
+*/
+vector<string> scanSpool(const string& spool, set<string>& known) {
+    vector<string> names;
+    DIR* dir = opendir(spool.c_str());
+    if (dir == nullptr) {
+        return names;
+    }
+
+    const string extension = ".trabajo";
+    while (dirent* entry = readdir(dir)) {
+        string file = entry->d_name;
+        if (file.size() <= extension.size() || file.compare(file.size() - extension.size(), extension.size(), extension) != 0) {
+            continue;
+        }
+        string name = file.substr(0, file.size() - extension.size());
+        if (known.count(name) || fileExists(spool + "/" + name + ".resultado")) {
+            continue;
+        }
+        known.insert(name);
+        names.push_back(name);
+    }
+    closedir(dir);
+
+    sort(names.begin(), names.end());
+    return names;
+}
+
+/*
+Función sendJob
+Descripción:
+    Envía a un esclavo la definición de un trabajo: su id seguido del objetivo empaquetado
+    con packSearch (texto cifrado, frase, modo, IV, posición y espacio de llaves).
+*/
+void sendJob(uint64_t job_id, const SearchTarget& target, int worker) {
+    vector<uint64_t> packed;
+    packSearch(target, packed);
+    packed.insert(packed.begin(), job_id);
+    MPI_Send(packed.data(), packed.size(), MPI_UINT64_T, worker, TAG_JOB, MPI_COMM_WORLD);
+}
+
+/*
+Función expiredLease
+Retorno:
+    map<uint64_t, Lease>::iterator, una unidad del trabajo cuyo arrendamiento venció, o end()
+*/
+map<uint64_t, Lease>::iterator expiredLease(Job& job, double now) {
+    return find_if(job.outstanding.begin(), job.outstanding.end(),
+                   [now](const pair<const uint64_t, Lease>& entry) { return entry.second.deadline < now; });
+}
+
+/*
+Función pickJob
+Descripción:
+    Elige el trabajo para la siguiente unidad: el de mayor prioridad con índices por entregar
+    o con una unidad vencida; entre trabajos de igual prioridad, el que lleva más tiempo sin
+    recibir unidades. Como la decisión se toma en cada solicitud, un trabajo urgente desplaza
+    a los de menor prioridad en el siguiente límite de unidad.
+Retorno:
+    map<uint64_t, Job>::iterator, trabajo elegido o end() si no hay trabajo
+*/
+map<uint64_t, Job>::iterator pickJob(map<uint64_t, Job>& jobs, double now) {
+    auto best = jobs.end();
+    for (auto it = jobs.begin(); it != jobs.end(); ++it) {
+        if (it->second.keys_exhausted && expiredLease(it->second, now) == it->second.outstanding.end()) {
+            continue;
+        }
+        if (best == jobs.end() || it->second.priority > best->second.priority ||
+            (it->second.priority == best->second.priority && it->second.last_grant < best->second.last_grant)) {
+            best = it;
+        }
+    }
+    return best;
+}
+
+/*
+Función runMaster
+Descripción:
+    Ciclo del maestro: revisa el spool, reparte unidades según prioridad (primero las vencidas
+    del trabajo elegido), recibe resultados y cancela en los esclavos los trabajos terminados.
+*/
+void runMaster(const string& spool, int size) {
+    const uint64_t work_unit_size = search_profile.work_unit_size;
+    map<uint64_t, Job> jobs;
+    map<uint64_t, double> job_start;
+    set<string> known;
+    vector<set<uint64_t>> worker_jobs(size);  // Trabajos que cada esclavo ya conoce
+    vector<int> idle_workers;                  // Esclavos esperando a que llegue un trabajo
+    uint64_t next_job_id = 0;
+    uint64_t grant_counter = 0;
+    double last_scan = -spool_scan_interval;
+    MPI_Status status;
+
+    // Cierra un trabajo y avisa a los esclavos que lo conocen que lo abandonen
+    auto retireJob = [&](map<uint64_t, Job>::iterator job, bool found, uint64_t key, double now) {
+        uint64_t job_id = job->first;
+        finishJob(spool, job->second, found, key, now - job_start[job_id]);
+        jobs.erase(job);
+        job_start.erase(job_id);
+        for (int i = 1; i < size; i++) {
+            if (worker_jobs[i].erase(job_id)) {
+                MPI_Send(&job_id, 1, MPI_UINT64_T, i, TAG_CANCEL, MPI_COMM_WORLD);
+            }
+        }
+    };
+
+    while (true) {
+        double now = MPI_Wtime();
+
+        if (now - last_scan >= spool_scan_interval) {
+            last_scan = now;
+
+            if (fileExists(spool + "/detener")) {
+                unlink((spool + "/detener").c_str());
+                break;
+            }
+
+            for (const string& name : scanSpool(spool, known)) {
+                Job job;
+                string error;
+                if (!loadJob(spool, name, job, error)) {
+                    rejectJob(spool, name, error);
+                    continue;
+                }
+                cout << "Nuevo trabajo " << name << " (prioridad " << job.priority << ") desde el índice " << job.next_key
+                     << " hasta " << job.end_key << endl;
+                job_start[next_job_id] = now;
+                jobs[next_job_id++] = job;
+            }
+
+            for (auto& entry : jobs) {
+                saveProgress(spool, entry.second);
+            }
+        }
+
+        int flag;
+        MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &flag, &status);
+
+        if (flag) {
+            int worker_rank = status.MPI_SOURCE;
+            uint64_t message[3];
+            MPI_Recv(message, 3, MPI_UINT64_T, worker_rank, status.MPI_TAG, MPI_COMM_WORLD, &status);
+
+            if (status.MPI_TAG == TAG_REQUEST) {
+                // La unidad terminada deja de estar pendiente (si el trabajo sigue activo). Si
+                // ya se había reasignado, la primera confirmación basta y la otra se ignora
+                auto done = jobs.find(message[0]);
+                if (done != jobs.end()) {
+                    done->second.outstanding.erase(message[1]);
+                    if (done->second.keys_exhausted && done->second.outstanding.empty()) {
+                        retireJob(done, false, 0, now);
+                    }
+                }
+                idle_workers.push_back(worker_rank);
+            } else if (status.MPI_TAG == TAG_RESULT) {
+                auto solved = jobs.find(message[0]);
+                if (solved != jobs.end()) {
+                    retireJob(solved, true, message[1], now);
+                }
+            }
+        }
+
+        // Atender a los esclavos en espera mientras haya trabajo
+        while (!idle_workers.empty()) {
+            auto job = pickJob(jobs, now);
+            if (job == jobs.end()) {
+                break;
+            }
+
+            int worker_rank = idle_workers.back();
+            idle_workers.pop_back();
+
+            if (!worker_jobs[worker_rank].count(job->first)) {
+                sendJob(job->first, job->second.target, worker_rank);
+                worker_jobs[worker_rank].insert(job->first);
+            }
+
+            // Primero reasignar una unidad vencida del trabajo, luego entregar una nueva
+            Job& state = job->second;
+            uint64_t work_unit[3] = {job->first, 0, 0};
+            auto expired = expiredLease(state, now);
+            if (expired != state.outstanding.end()) {
+                cout << "Reasignando unidad " << expired->first << " del trabajo " << state.name << " al proceso "
+                     << worker_rank << endl;
+                expired->second.worker = worker_rank;
+                expired->second.deadline = now + job_lease_timeout;
+                work_unit[1] = expired->second.start;
+                work_unit[2] = expired->second.end;
+            } else {
+                Lease lease;
+                lease.start = state.next_key;
+                if (state.end_key - state.next_key <= work_unit_size - 1) {
+                    lease.end = state.end_key;
+                    state.keys_exhausted = true;
+                } else {
+                    lease.end = state.next_key + work_unit_size - 1;
+                    state.next_key = lease.end + 1;
+                }
+                lease.worker = worker_rank;
+                lease.deadline = now + job_lease_timeout;
+                state.outstanding[lease.start] = lease;
+                work_unit[1] = lease.start;
+                work_unit[2] = lease.end;
+            }
+            state.last_grant = ++grant_counter;
+
+            MPI_Send(work_unit, 3, MPI_UINT64_T, worker_rank, TAG_UNIT, MPI_COMM_WORLD);
+        }
+
+        if (!flag) {
+            usleep(1000);
+        }
+    }
+
+    // Guardar el progreso y terminar a los esclavos
+    for (auto& entry : jobs) {
+        saveProgress(spool, entry.second);
+    }
+    for (int i = 1; i < size; i++) {
+        uint64_t dummy = 0;
+        MPI_Send(&dummy, 1, MPI_UINT64_T, i, TAG_SHUTDOWN, MPI_COMM_WORLD);
+    }
+    cout << "Servicio detenido con " << jobs.size() << " trabajos pendientes" << endl;
+}
+
+/*
+Función receiveControl
+Parámetros:
+    status: MPI_Status, mensaje ya sondeado del maestro
+    jobs: map<uint64_t, WorkerJob>, trabajos conocidos por el esclavo
+    current_job: uint64_t, trabajo en curso
+    rank: int, rango del esclavo
+    backend: int, implementación de DES de los kernels
+Descripción:
+    Procesa un mensaje de control (definición, cancelación o fin del servicio). Al recibir
+    una definición elige los kernels del trabajo y arranca su verificador.
+Retorno:
+    int, 1 si se canceló el trabajo en curso, 2 si el servicio termina, 0 en otro caso
+*/
+int receiveControl(MPI_Status& status, map<uint64_t, WorkerJob>& jobs, uint64_t current_job, int rank, int backend) {
+    if (status.MPI_TAG == TAG_JOB) {
+        int length;
+        MPI_Get_count(&status, MPI_UINT64_T, &length);
+        vector<uint64_t> packed(length);
+        MPI_Recv(packed.data(), length, MPI_UINT64_T, 0, TAG_JOB, MPI_COMM_WORLD, &status);
+
+        WorkerJob& job = jobs[packed[0]];
+        unpackSearch(vector<uint64_t>(packed.begin() + 1, packed.end()), job.target);
+        string description;
+        job.kernel = selectKernel(job.target, backend, job.batch, description);
+        job.verifier.reset(new CandidateVerifier(job.target, rank));
+        return 0;
+    }
+
+    uint64_t value;
+    MPI_Recv(&value, 1, MPI_UINT64_T, 0, status.MPI_TAG, MPI_COMM_WORLD, &status);
+
+    if (status.MPI_TAG == TAG_CANCEL) {
+        jobs.erase(value);
+        return value == current_job ? 1 : 0;
+    }
+    return status.MPI_TAG == TAG_SHUTDOWN ? 2 : 0;
+}
+
+/*
+Función runWorker
+Descripción:
+    Ciclo del esclavo: pide unidades y las recorre con el kernel del trabajo. Los candidatos
+    van al verificador del trabajo y cada search_profile.stop_check_interval llaves se revisa
+    si se confirmó uno o si llegó una cancelación o el fin del servicio. Una unidad solo se
+    informa como terminada cuando sus candidatos ya se verificaron.
+*/
+void runWorker(int rank, int backend) {
+    const uint64_t check_mask = search_profile.stop_check_interval - 1;
+    map<uint64_t, WorkerJob> jobs;
+    uint64_t completed[2] = {no_job, 0};
+    MPI_Status status;
+
+    while (true) {
+        MPI_Send(completed, 2, MPI_UINT64_T, 0, TAG_REQUEST, MPI_COMM_WORLD);
+        completed[0] = no_job;
+
+        // Esperar la unidad; antes pueden llegar definiciones o cancelaciones
+        uint64_t work_unit[3];
+        bool shutdown = false;
+        while (true) {
+            MPI_Probe(0, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
+            if (status.MPI_TAG == TAG_UNIT) {
+                MPI_Recv(work_unit, 3, MPI_UINT64_T, 0, TAG_UNIT, MPI_COMM_WORLD, &status);
+                break;
+            }
+            if (receiveControl(status, jobs, no_job, rank, backend) == 2) {
+                shutdown = true;
+                break;
+            }
+        }
+        if (shutdown) {
+            return;
+        }
+
+        auto job = jobs.find(work_unit[0]);
+        if (job == jobs.end()) {
+            continue;
+        }
+
+        // El kernel por lotes es global en busqueda.h: se fija el del trabajo de esta unidad
+        WorkerJob& current = job->second;
+        batch_kernel = current.batch;
+
+        uint64_t start = work_unit[1];
+        uint64_t end = work_unit[2];
+        uint64_t i = start;
+        uint64_t keys[des_lanes];
+        bool cancelled = false;
+        bool found = false;
+        while (true) {
+            unsigned count = (end - i < des_lanes) ? (unsigned)(end - i + 1) : des_lanes;
+            for (unsigned hits = testKeys(i, count, current.kernel, current.target, keys), lane = 0; hits != 0; hits >>= 1, lane++) {
+                if (hits & 1) {
+                    current.verifier->submit(keys[lane]);
+                }
+            }
+            i += count;
+
+            if (((i - start) & check_mask) < count) {
+                if (current.verifier->confirmed()) {
+                    found = true;
+                    break;
+                }
+                int flag;
+                MPI_Iprobe(0, MPI_ANY_TAG, MPI_COMM_WORLD, &flag, &status);
+                while (flag && !cancelled) {
+                    int control = receiveControl(status, jobs, work_unit[0], rank, backend);
+                    if (control == 2) {
+                        return;
+                    }
+                    cancelled = control == 1;
+                    MPI_Iprobe(0, MPI_ANY_TAG, MPI_COMM_WORLD, &flag, &status);
+                }
+                if (cancelled) {
+                    break;
+                }
+            }
+
+            if (i - 1 == end) {
+                break;
+            }
+        }
+
+        if (cancelled) {
+            continue;  // El trabajo ya no existe en este esclavo
+        }
+        if (!found) {
+            found = current.verifier->drain();
+        }
+
+        if (found) {
+            uint64_t result[2] = {work_unit[0], current.verifier->key()};
+            cout << "Proceso " << rank << " encontró la llave " << result[1] << " del trabajo " << work_unit[0] << endl;
+            MPI_Send(result, 2, MPI_UINT64_T, 0, TAG_RESULT, MPI_COMM_WORLD);
+            jobs.erase(job);  // La cancelación que enviará el maestro ya no tiene efecto
+            continue;
+        }
+
+        completed[0] = work_unit[0];
+        completed[1] = start;
+    }
+}
+
+int main(int argc, char **argv) {
+    MPI_Init(&argc, &argv);
+
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    int des_backend = -1;  // Implementación de DES de los kernels (-des), -1 para usar la del perfil
+    string profile_file;   // Perfil de rendimiento (-perfil), vacío para el del nodo
+    bool valid_args = argc >= 2 && argc % 2 == 0 && size >= 2;
+    for (int i = 2; i + 1 < argc && valid_args; i += 2) {
+        string option = argv[i];
+        string value = argv[i + 1];
+        if (option == "-des") {
+            des_backend = (value == "openssl") ? DES_OPENSSL : (value == "propio") ? DES_INTERLEAVED : -1;
+            valid_args = des_backend >= 0;
+        } else if (option == "-perfil") {
+            profile_file = value;
+        } else {
+            valid_args = false;
+        }
+    }
+
+    if (!valid_args) {
+        if (rank == 0) {
+            cerr << "Uso: mpirun -np <n >= 2> " << argv[0] << " <directorio_spool> [-des propio|openssl] [-perfil <archivo>]" << endl;
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Perfil del nodo: DES, sondeo y (en el maestro) tamaño de las unidades
+    bool explicit_profile = !profile_file.empty();
+    if (!explicit_profile) {
+        profile_file = defaultProfileName();
+    }
+    if (!loadProfile(profile_file, search_profile) && explicit_profile) {
+        cerr << "No se pudo leer el perfil " << profile_file << endl;
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    if (des_backend < 0) {
+        des_backend = search_profile.des_backend;
+    }
+
+    if (rank == 0) {
+        runMaster(argv[1], size);
+    } else {
+        runWorker(rank, des_backend);
+    }
+
+    MPI_Finalize();
+    return 0;
+}
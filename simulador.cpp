@@ -0,0 +1,721 @@
+/*
+Proyecto MPI - Simulador de eventos discretos de las estrategias de reparto
+Grupo 4
+
+Compilar: g++ -O2 simulador.cpp -o build/simulador.o
+Ejecutar: ./build/simulador.o -e maestro|rma|bloques|intercalado|dfs|todas -n <procesos>[,<procesos>...]
+              [-perfil <archivo>] [-traza <archivo.json>]... [-velocidad <llaves/s>] [-variacion <fracción>]
+              [-latencia <s>] [-servicio <s>] [-atomico <s>] [-envio <s>] [-revision <s>]
+              [-unidad <llaves>] [-sondeo <llaves>] [-rango <llaves>] [-lote <n>] [-sin-adelanto]
+              [-bits <n>] [-repeticiones <n>] [-horizonte <s>] [-semilla <n>]
+
+Predice, sin reservar los nodos, cómo se comportan las estrategias de busqueda.o con miles de
+procesos. Reproduce sus patrones de mensajes:
+    maestro: solicitudes y concesiones por lotes con un maestro que atiende en orden (cola FIFO),
+             pedido adelantado de la siguiente concesión y difusión de detener desde el maestro.
+    rma:     fetch-and-add remoto por unidad, serializado en el rango 0, sin pedido adelantado.
+    bloques, intercalado, dfs: reparto estático; solo hay calibración y el aviso de detener.
+Todas sondean la señal de detener cada <sondeo> llaves, con un costo de <revision> s por sondeo.
+
+maestro y rma se simulan evento por evento hasta el horizonte (o hasta agotar el espacio) y
+después se extrapola con el rendimiento en régimen; las estáticas se calculan directamente.
+Para cada cantidad de procesos se informa el rendimiento, la utilización de los procesos y del
+maestro, la cola media del maestro, el tiempo esperado hasta encontrar una llave al azar y el
+tiempo hasta que todos se detienen.
+
+Calibración: -perfil lee un perfil de -autoajuste (velocidad, revision, concesion, unidad,
+sondeo, rango) y -traza lee trazas de una ejecución real con -t (duración media de las
+concesiones del maestro y de las unidades de los esclavos). Las opciones explícitas mandan.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <queue>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <cstdint>
+
+using namespace std;
+
+const double calibration_time = 0.2;    // Segundos de calibración de bloques e intercalado (como busqueda.h)
+const uint64_t weight_resolution = 16;  // Llaves por periodo del proceso más rápido en intercalado
+const uint64_t default_max_events = 20000000;  // Eventos simulados como máximo por configuración
+
+// Parámetros de una simulación
+struct SimParams {
+    string strategy = "maestro";
+    double key_rate = 5e6;         // Llaves por segundo de un proceso (media)
+    double rate_spread = 0;        // Variación uniforme de la velocidad (±fracción)
+    double latency = 5e-6;         // Segundos de un mensaje en un sentido
+    double service_time = 2e-6;    // Segundos del maestro por mensaje atendido
+    double atomic_time = 1e-6;     // Segundos del rango 0 por fetch-and-add (rma)
+    double send_cost = 1e-6;       // Segundos de CPU por envío al difundir detener
+    double poll_cost = 0.5e-6;     // Segundos por revisión de la señal de detener
+    double unit_size = 1e6;        // Llaves por unidad de trabajo (maestro, rma)
+    double poll_interval = 4096;   // Llaves entre revisiones de detener
+    double range_size = 5e7;       // Llaves por proceso y ronda (bloques)
+    int grant_units = 8;           // Unidades por concesión como máximo (maestro)
+    bool prefetch = true;          // El esclavo pide la siguiente concesión antes de la última unidad
+    double space_bits = 56;        // Espacio de 2^bits llaves
+    int repetitions = 1000;        // Llaves al azar para el tiempo esperado
+    double horizon = 10;           // Segundos simulados como máximo (maestro, rma)
+    uint64_t max_events = default_max_events;
+    unsigned seed = 1;
+};
+
+// Resultado de una simulación
+struct SimResult {
+    double throughput = 0;     // Llaves por segundo en régimen
+    double ideal = 0;          // Suma de las velocidades de todos los procesos
+    double worker_util = 0;    // Fracción del tiempo que los procesos buscan
+    double server_util = -1;   // Fracción del tiempo ocupado del maestro o del rango 0 (rma), -1 si no aplica
+    double mean_queue = -1;    // Solicitudes en cola en el maestro (media), -1 si no aplica
+    double mean_find = 0;      // Tiempo esperado hasta detectar la llave
+    double stop_delay = 0;     // Tiempo desde la detección hasta que todos se detienen
+    bool extrapolated = false; // El tiempo de búsqueda supera lo simulado
+};
+
+/*
+Función readFields
+Parámetros:
+    filename: string, archivo de líneas clave=valor (# para comentarios)
+    fields: map, claves leídas
+Descripción:
+    Lee un perfil con el mismo formato que usa busqueda.h.
+Retorno:
+    bool, true si el archivo existe
+*/
+bool readFields(const string& filename, map<string, string>& fields) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+    string line;
+    while (getline(file, line)) {
+        size_t equals = line.find('=');
+        if (!line.empty() && line[0] != '#' && equals != string::npos) {
+            fields[line.substr(0, equals)] = line.substr(equals + 1);
+        }
+    }
+    return true;
+}
+
+/*
+Función applyProfile
+Parámetros:
+    filename: string, perfil generado por busqueda.o -autoajuste
+    params: SimParams, parámetros a calibrar
+Descripción:
+    Toma del perfil la velocidad medida, el costo de un sondeo, la ida y vuelta de una concesión
+    (la mitad se usa como latencia) y los tamaños de unidad, sondeo y ronda.
+Retorno:
+    bool, true si el archivo existe
+*/
+bool applyProfile(const string& filename, SimParams& params) {
+    map<string, string> fields;
+    if (!readFields(filename, fields)) {
+        return false;
+    }
+    if (fields.count("velocidad")) params.key_rate = stod(fields["velocidad"]);
+    if (fields.count("revision")) params.poll_cost = stod(fields["revision"]);
+    if (fields.count("concesion")) params.latency = stod(fields["concesion"]) / 2;
+    if (fields.count("unidad")) params.unit_size = stod(fields["unidad"]);
+    if (fields.count("sondeo")) params.poll_interval = stod(fields["sondeo"]);
+    if (fields.count("rango")) params.range_size = stod(fields["rango"]);
+    return true;
+}
+
+/*
+Función jsonNumber
+Descripción:
+    Valor numérico de "clave": en una línea de la traza, o -1 si no está.
+*/
+double jsonNumber(const string& line, const string& key) {
+    size_t at = line.find("\"" + key + "\":");
+    return (at == string::npos) ? -1 : atof(line.c_str() + at + key.size() + 3);
+}
+
+/*
+Función applyTraces
+Parámetros:
+    files: vector<string>, trazas .json de una ejecución con -t (una por proceso)
+    params: SimParams, parámetros a calibrar
+Descripción:
+    La duración media de las concesiones del maestro es el tiempo de servicio por mensaje, y la
+    duración media de las unidades de los esclavos da la velocidad (unidades de -unidad llaves,
+    es decir, trazas de maestro o rma). writeTrace escribe un evento por línea.
+Retorno:
+    bool, true si se pudieron leer todas
+*/
+bool applyTraces(const vector<string>& files, SimParams& params) {
+    double grant_total = 0, unit_total = 0;
+    uint64_t grants = 0, units = 0;
+    for (const string& filename : files) {
+        ifstream file(filename);
+        if (!file.is_open()) {
+            cerr << "No se pudo abrir la traza " << filename << endl;
+            return false;
+        }
+        string line;
+        while (getline(file, line)) {
+            double duration = jsonNumber(line, "dur");
+            if (duration < 0) {
+                continue;
+            }
+            if (line.find("\"name\":\"concesion\"") != string::npos) {
+                grant_total += duration * 1e-6;
+                grants++;
+            } else if (line.find("\"name\":\"unidad\"") != string::npos) {
+                unit_total += duration * 1e-6;
+                units++;
+            }
+        }
+    }
+    if (grants > 0) {
+        params.service_time = grant_total / grants;
+        cout << "Traza: " << grants << " concesiones, servicio medio " << setprecision(3) << params.service_time * 1e6 << " us" << endl;
+    }
+    if (units > 0 && unit_total > 0) {
+        params.key_rate = params.unit_size * units / unit_total;
+        cout << "Traza: " << units << " unidades, " << setprecision(3) << params.key_rate << " llaves/s por proceso" << endl;
+    }
+    return true;
+}
+
+/*
+Función effectiveRate
+Descripción:
+    Velocidad de búsqueda descontando el tiempo de las revisiones de detener.
+*/
+double effectiveRate(double rate, const SimParams& params) {
+    return 1.0 / (1.0 / rate + params.poll_cost / params.poll_interval);
+}
+
+/*
+Función detectTime
+Parámetros:
+    checked: double, llaves que el proceso revisó antes de la llave (en su recorrido)
+    rate: double, velocidad efectiva del proceso
+Descripción:
+    La llave se confirma en el primer sondeo después de probarla.
+Retorno:
+    double, segundos de búsqueda del proceso hasta detectar la llave
+*/
+double detectTime(double checked, double rate, const SimParams& params) {
+    return ceil((checked + 1) / params.poll_interval) * params.poll_interval / rate;
+}
+
+/*
+Función broadcastDelay
+Parámetros:
+    senders: int, avisos que se envían uno tras otro
+    rates: vector<double>, velocidades de los procesos que deben notar el aviso
+Descripción:
+    El último aviso sale después de senders envíos, tarda una latencia y el proceso más lento
+    lo nota en su siguiente sondeo (en el peor caso, un intervalo completo).
+Retorno:
+    double, segundos hasta que todos se detienen
+*/
+double broadcastDelay(int senders, const vector<double>& rates, const SimParams& params) {
+    double slowest = *min_element(rates.begin(), rates.end());
+    return max(0, senders) * params.send_cost + params.latency + params.poll_interval / slowest;
+}
+
+// Evento de la simulación por unidades de trabajo
+struct SimEvent {
+    double time;
+    int type;
+    int rank;
+    uint64_t first;  // Primera unidad de una concesión
+    uint64_t count;  // Unidades de una concesión
+    bool operator>(const SimEvent& other) const { return time > other.time; }
+};
+
+enum { EV_REQUEST, EV_SERVED, EV_GRANT, EV_UNIT_DONE };
+
+// Unidad ya empezada: cuándo y por quién (para ubicar la llave después)
+struct UnitRecord {
+    double start;
+    int worker;
+};
+
+/*
+Función simulateUnits
+Parámetros:
+    params: SimParams, parámetros
+    rates: vector<double>, velocidad efectiva de cada proceso (0 si no busca)
+    first_worker: int, primer proceso que busca (1 con maestro, 0 con rma)
+    service: double, segundos del servidor (maestro o rango 0) por solicitud
+    batch: int, unidades por respuesta como máximo
+    prefetch: bool, pedir antes de la última unidad
+    space: double, llaves del espacio
+    result: SimResult, utilizaciones y rendimiento
+    units: vector<UnitRecord>, unidades empezadas (salida)
+    end_time, assigned_keys: fin de lo simulado y llaves ya repartidas (salida)
+    queue_wait: double, espera media en la cola del servidor (salida)
+Descripción:
+    Simulación de eventos discretos del reparto por solicitudes: los procesos piden unidades,
+    el servidor las atiende de a una en orden de llegada y responde con hasta batch unidades,
+    y cada proceso busca sus unidades a su velocidad. Termina al agotar el espacio, al llegar
+    al horizonte o al límite de eventos. El rendimiento, las utilizaciones y la cola se miden
+    en la segunda mitad (el arranque, con todos pidiendo a la vez, no es representativo).
+*/
+void simulateUnits(const SimParams& params, const vector<double>& rates, int first_worker, double service, int batch,
+                   bool prefetch, double space, SimResult& result, vector<UnitRecord>& units, double& end_time,
+                   double& assigned_keys, double& queue_wait) {
+    int ranks = rates.size();
+    int workers = ranks - first_worker;
+    double total_units = ceil(space / params.unit_size);
+    double steady_start = params.horizon / 2;
+
+    priority_queue<SimEvent, vector<SimEvent>, greater<SimEvent>> events;
+    vector<deque<uint64_t>> queued(ranks);
+    vector<bool> requested(ranks, false);
+    vector<bool> busy(ranks, false);
+    deque<pair<int, double>> server_queue;  // Solicitudes esperando: proceso y llegada
+    bool serving = false;
+    uint64_t next_unit = 0;
+
+    // Totales de toda la simulación y de la segunda mitad (régimen)
+    double server_busy[2] = {0, 0}, queue_area[2] = {0, 0}, wait_total[2] = {0, 0};
+    uint64_t served[2] = {0, 0};
+    double last_time = 0;
+    uint64_t processed = 0;
+
+    auto latency = [&](int rank) { return rank == 0 ? 0.0 : params.latency; };
+    auto unitKeys = [&](uint64_t unit) { return min(params.unit_size, space - unit * params.unit_size); };
+
+    auto serve = [&](double now) {
+        int steady = now >= steady_start;
+        wait_total[0] += now - server_queue.front().second;
+        wait_total[steady] += steady ? now - server_queue.front().second : 0;
+        events.push({now + service, EV_SERVED, server_queue.front().first, 0, 0});
+    };
+
+    auto startUnit = [&](int rank, double now) {
+        uint64_t unit = queued[rank].front();
+        queued[rank].pop_front();
+        if (units.size() <= unit) {
+            units.resize(unit + 1, UnitRecord{-1, -1});
+        }
+        if (units[unit].start < 0) {
+            units[unit] = UnitRecord{now, rank};
+        }
+        if (queued[rank].empty() && prefetch && !requested[rank]) {
+            requested[rank] = true;
+            events.push({now + latency(rank), EV_REQUEST, rank, 0, 0});
+        }
+        busy[rank] = true;
+        events.push({now + unitKeys(unit) / rates[rank], EV_UNIT_DONE, rank, unit, 1});
+    };
+
+    for (int rank = first_worker; rank < ranks; rank++) {
+        requested[rank] = true;
+        events.push({latency(rank), EV_REQUEST, rank, 0, 0});
+    }
+
+    double now = 0;
+    while (!events.empty() && processed < params.max_events) {
+        SimEvent event = events.top();
+        if (event.time > params.horizon) {
+            break;
+        }
+        events.pop();
+        now = event.time;
+        processed++;
+        queue_area[0] += server_queue.size() * (now - last_time);
+        if (now > steady_start) {
+            queue_area[1] += server_queue.size() * (now - max(last_time, steady_start));
+        }
+        last_time = now;
+
+        switch (event.type) {
+            case EV_REQUEST:
+                server_queue.push_back(make_pair(event.rank, now));
+                if (!serving) {
+                    serving = true;
+                    serve(now);
+                }
+                break;
+
+            case EV_SERVED: {
+                server_queue.pop_front();
+                for (int steady = 0; steady <= (now - service >= steady_start ? 1 : 0); steady++) {
+                    server_busy[steady] += service;
+                    served[steady]++;
+                }
+                double remaining = total_units - next_unit;
+                uint64_t count = (uint64_t)min<double>(batch, max(1.0, floor(remaining / workers)));
+                count = (uint64_t)min<double>(count, remaining);
+                if (count > 0) {
+                    events.push({now + latency(event.rank), EV_GRANT, event.rank, next_unit, count});
+                    next_unit += count;
+                }
+                if (!server_queue.empty()) {
+                    serve(now);
+                } else {
+                    serving = false;
+                }
+                break;
+            }
+
+            case EV_GRANT:
+                for (uint64_t unit = event.first; unit < event.first + event.count; unit++) {
+                    queued[event.rank].push_back(unit);
+                }
+                requested[event.rank] = false;
+                if (!busy[event.rank]) {
+                    startUnit(event.rank, now);
+                }
+                break;
+
+            case EV_UNIT_DONE:
+                busy[event.rank] = false;
+                if (!queued[event.rank].empty()) {
+                    startUnit(event.rank, now);
+                } else if (!requested[event.rank]) {
+                    requested[event.rank] = true;
+                    events.push({now + latency(event.rank), EV_REQUEST, event.rank, 0, 0});
+                }
+                break;
+        }
+    }
+
+    // Si se agotó el espacio o el límite de eventos antes de la mitad, se usa toda la simulación
+    bool exhausted = events.empty();
+    end_time = max(now, 1e-9);
+    int steady = (!exhausted && end_time > steady_start) ? 1 : 0;
+    double window_start = steady ? steady_start : 0;
+    double window = end_time - window_start;
+    assigned_keys = min(space, next_unit * params.unit_size);
+
+    // Llaves y tiempo de búsqueda de cada unidad dentro de la ventana
+    double window_keys = 0, busy_time = 0;
+    for (uint64_t unit = 0; unit < units.size(); unit++) {
+        if (units[unit].start < 0) {
+            continue;
+        }
+        double rate = rates[units[unit].worker];
+        double start = units[unit].start;
+        double overlap = min(end_time, start + unitKeys(unit) / rate) - max(window_start, start);
+        if (overlap > 0) {
+            window_keys += overlap * rate;
+            busy_time += overlap;
+        }
+    }
+
+    result.throughput = window_keys / window;
+    result.worker_util = min(1.0, busy_time / (workers * window));
+    result.server_util = min(1.0, server_busy[steady] / window);
+    result.mean_queue = queue_area[steady] / window;
+    queue_wait = served[steady] > 0 ? wait_total[steady] / served[steady] : 0;
+}
+
+/*
+Función simulateDynamic
+Descripción:
+    maestro o rma: simula el reparto por unidades y luego calcula, para llaves al azar, cuándo
+    se detectan (directamente si su unidad se empezó dentro de lo simulado, si no extrapolando
+    con el rendimiento en régimen) y cuánto tarda en detenerse el resto.
+*/
+SimResult simulateDynamic(const SimParams& params, const vector<double>& raw_rates, mt19937_64& random) {
+    bool master = params.strategy == "maestro";
+    int ranks = raw_rates.size();
+    double space = pow(2.0, params.space_bits);
+
+    vector<double> rates(ranks);
+    for (int rank = 0; rank < ranks; rank++) {
+        rates[rank] = (master && rank == 0) ? 0 : effectiveRate(raw_rates[rank], params);
+    }
+
+    SimResult result;
+    result.ideal = accumulate(raw_rates.begin() + (master ? 1 : 0), raw_rates.end(), 0.0);
+    vector<UnitRecord> units;
+    double end_time, assigned_keys, queue_wait;
+    simulateUnits(params, rates, master ? 1 : 0, master ? params.service_time : params.atomic_time,
+                  master ? params.grant_units : 1, master && params.prefetch, space, result, units, end_time,
+                  assigned_keys, queue_wait);
+    if (!master) {
+        result.mean_queue = -1;  // El contador no tiene cola visible para el usuario
+    }
+
+    vector<double> workers(rates.begin() + (master ? 1 : 0), rates.end());
+    double mean_rate = accumulate(workers.begin(), workers.end(), 0.0) / workers.size();
+    if (master) {
+        // Resultado al maestro (espera su turno en la cola) y difusión desde el maestro
+        result.stop_delay = params.latency + queue_wait + params.service_time + broadcastDelay(ranks - 2, workers, params);
+    } else {
+        result.stop_delay = broadcastDelay(ranks - 1, workers, params);
+    }
+
+    uniform_real_distribution<double> position(0, space);
+    double total = 0;
+    for (int i = 0; i < params.repetitions; i++) {
+        double key = floor(position(random));
+        uint64_t unit = (uint64_t)(key / params.unit_size);
+        if (unit < units.size() && units[unit].start >= 0) {
+            const UnitRecord& record = units[unit];
+            total += record.start + detectTime(key - unit * params.unit_size, rates[record.worker], params);
+        } else {
+            result.extrapolated = true;
+            total += end_time + max(0.0, key - assigned_keys) / max(result.throughput, 1e-9) + params.unit_size / mean_rate;
+        }
+    }
+    result.mean_find = total / params.repetitions;
+    return result;
+}
+
+/*
+Función simulateStatic
+Descripción:
+    bloques, intercalado y dfs: el reparto no depende de mensajes, así que el momento en que
+    el dueño de la llave la detecta se calcula directamente con la misma aritmética de
+    busqueda.h (rangos proporcionales a la velocidad, bloques intercalados por peso o índices
+    rank, rank + size, ...). Después la llave se difunde a los demás procesos.
+*/
+SimResult simulateStatic(const SimParams& params, const vector<double>& raw_rates, mt19937_64& random) {
+    int ranks = raw_rates.size();
+    double space = pow(2.0, params.space_bits);
+    vector<double> rates(ranks);
+    for (int rank = 0; rank < ranks; rank++) {
+        rates[rank] = effectiveRate(raw_rates[rank], params);
+    }
+    double total_rate = accumulate(raw_rates.begin(), raw_rates.end(), 0.0);
+    double effective_total = accumulate(rates.begin(), rates.end(), 0.0);
+
+    // Calibración y allgather de velocidades (dfs no calibra)
+    double startup = 0;
+    if (params.strategy != "dfs") {
+        startup = calibration_time + 2 * params.latency * ceil(log2(max(2, ranks)));
+    }
+
+    // Reparto: tamaño de cada proceso por ronda (bloques) o por periodo (intercalado)
+    vector<double> share(ranks, 1);
+    if (params.strategy == "bloques") {
+        double round_size = params.range_size * ranks;
+        double assigned = 0;
+        for (int rank = 0; rank < ranks; rank++) {
+            share[rank] = (rank == ranks - 1) ? round_size - assigned : max(1.0, floor(round_size * raw_rates[rank] / total_rate));
+            assigned += share[rank];
+        }
+    } else if (params.strategy == "intercalado") {
+        double max_rate = *max_element(raw_rates.begin(), raw_rates.end());
+        uint64_t common = 0;
+        vector<uint64_t> weights(ranks);
+        for (int rank = 0; rank < ranks; rank++) {
+            weights[rank] = max<uint64_t>(1, llround(weight_resolution * raw_rates[rank] / max_rate));
+            common = gcd(common, weights[rank]);
+        }
+        for (int rank = 0; rank < ranks; rank++) {
+            share[rank] = weights[rank] / common;
+        }
+    }
+    vector<double> offsets(ranks + 1, 0);
+    partial_sum(share.begin(), share.end(), offsets.begin() + 1);
+    double period = offsets[ranks];
+
+    SimResult result;
+    result.ideal = total_rate;
+    result.throughput = effective_total;
+    uniform_real_distribution<double> position(0, space);
+    double total = 0;
+    for (int i = 0; i < params.repetitions; i++) {
+        double key = floor(position(random));
+        double round = floor(key / period);
+        double inside = key - round * period;
+        int owner = upper_bound(offsets.begin(), offsets.end(), inside) - offsets.begin() - 1;
+        double checked = round * share[owner] + (inside - offsets[owner]);
+        total += startup + detectTime(checked, rates[owner], params);
+    }
+    result.mean_find = total / params.repetitions;
+    result.worker_util = (result.mean_find - startup) / result.mean_find;
+    result.stop_delay = broadcastDelay(ranks - 1, rates, params);
+    return result;
+}
+
+/*
+Función formatTime
+Descripción:
+    Tiempo en la unidad más legible (us, ms, s, min, h, días o años).
+*/
+string formatTime(double seconds) {
+    ostringstream text;
+    text << fixed << setprecision(2);
+    if (seconds < 1e-3) text << seconds * 1e6 << " us";
+    else if (seconds < 1) text << seconds * 1e3 << " ms";
+    else if (seconds < 120) text << seconds << " s";
+    else if (seconds < 7200) text << seconds / 60 << " min";
+    else if (seconds < 172800) text << seconds / 3600 << " h";
+    else if (seconds < 2 * 31557600.0) text << seconds / 86400 << " días";
+    else text << seconds / 31557600.0 << " años";
+    return text.str();
+}
+
+/*
+Función percent
+Descripción:
+    Fracción como porcentaje, o "-" si no aplica (negativa).
+*/
+string percent(double fraction) {
+    ostringstream text;
+    if (fraction < 0) {
+        text << "-";
+    } else {
+        text << fixed << setprecision(1) << fraction * 100 << "%";
+    }
+    return text.str();
+}
+
+/*
+Función parseRanks
+Descripción:
+    Lista de cantidades de procesos separadas por comas.
+*/
+bool parseRanks(const string& value, vector<int>& ranks) {
+    stringstream list(value);
+    string item;
+    while (getline(list, item, ',')) {
+        int count = atoi(item.c_str());
+        if (count < 2) {
+            return false;
+        }
+        ranks.push_back(count);
+    }
+    return !ranks.empty();
+}
+
+int main(int argc, char **argv) {
+    SimParams params;
+    vector<int> rank_counts;
+    vector<string> traces;
+    string profile_file;
+    map<string, string> explicit_options;
+    bool valid_args = true;
+
+    // Primero se leen las fuentes de calibración; las opciones explícitas se aplican al final
+    for (int i = 1; i < argc && valid_args; i++) {
+        string option = argv[i];
+        if (option == "-sin-adelanto") {
+            params.prefetch = false;  // Opción sin valor
+            continue;
+        }
+        if (i + 1 >= argc) {
+            valid_args = false;
+            break;
+        }
+        string value = argv[++i];
+        if (option == "-e") {
+            params.strategy = value;
+        } else if (option == "-n") {
+            valid_args = parseRanks(value, rank_counts);
+        } else if (option == "-perfil") {
+            profile_file = value;
+        } else if (option == "-traza") {
+            traces.push_back(value);  // Se puede repetir
+        } else {
+            explicit_options[option] = value;
+        }
+    }
+
+    vector<string> strategies = {"maestro", "rma", "bloques", "intercalado", "dfs"};
+    if (params.strategy != "todas" && find(strategies.begin(), strategies.end(), params.strategy) == strategies.end()) {
+        valid_args = false;
+    }
+    if (!profile_file.empty() && !applyProfile(profile_file, params)) {
+        cerr << "No se pudo leer el perfil " << profile_file << endl;
+        return 1;
+    }
+    if (explicit_options.count("-unidad")) {
+        // La velocidad que se deduce de la traza depende del tamaño de unidad
+        params.unit_size = atof(explicit_options["-unidad"].c_str());
+    }
+    if (!traces.empty() && !applyTraces(traces, params)) {
+        return 1;
+    }
+
+    try {
+        for (auto& entry : explicit_options) {
+            const string& option = entry.first;
+            double number = stod(entry.second);
+            if (option == "-velocidad") params.key_rate = number;
+            else if (option == "-variacion") params.rate_spread = number;
+            else if (option == "-latencia") params.latency = number;
+            else if (option == "-servicio") params.service_time = number;
+            else if (option == "-atomico") params.atomic_time = number;
+            else if (option == "-envio") params.send_cost = number;
+            else if (option == "-revision") params.poll_cost = number;
+            else if (option == "-unidad") params.unit_size = number;
+            else if (option == "-sondeo") params.poll_interval = number;
+            else if (option == "-rango") params.range_size = number;
+            else if (option == "-lote") params.grant_units = (int)number;
+            else if (option == "-bits") params.space_bits = number;
+            else if (option == "-repeticiones") params.repetitions = (int)number;
+            else if (option == "-horizonte") params.horizon = number;
+            else if (option == "-semilla") params.seed = (unsigned)number;
+            else valid_args = false;
+        }
+    } catch (const exception&) {
+        valid_args = false;
+    }
+    valid_args = valid_args && !rank_counts.empty() && params.key_rate > 0 && params.unit_size >= 1 &&
+                 params.poll_interval >= 1 && params.range_size >= 1 && params.grant_units >= 1 &&
+                 params.repetitions >= 1 && params.rate_spread >= 0 && params.rate_spread < 1 &&
+                 params.space_bits >= 1 && params.space_bits <= 64;
+
+    if (!valid_args) {
+        cerr << "Uso: " << argv[0] << " -e maestro|rma|bloques|intercalado|dfs|todas -n <procesos>[,<procesos>...] [-perfil <archivo>] [-traza <archivo.json>]... [-velocidad <llaves/s>] [-variacion <fracción>] [-latencia <s>] [-servicio <s>] [-atomico <s>] [-envio <s>] [-revision <s>] [-unidad <llaves>] [-sondeo <llaves>] [-rango <llaves>] [-lote <n>] [-sin-adelanto] [-bits <n>] [-repeticiones <n>] [-horizonte <s>] [-semilla <n>]" << endl;
+        return 1;
+    }
+
+    cout << "Espacio: 2^" << params.space_bits << " llaves; " << setprecision(4) << params.key_rate << " llaves/s por proceso";
+    if (params.rate_spread > 0) {
+        cout << " (±" << params.rate_spread * 100 << "%)";
+    }
+    cout << "; latencia " << formatTime(params.latency) << ", servicio del maestro " << formatTime(params.service_time)
+         << ", sondeo cada " << params.poll_interval << " llaves (" << formatTime(params.poll_cost) << ")" << endl;
+    cout << "Unidades de " << params.unit_size << " llaves, hasta " << params.grant_units << " por concesión"
+         << (params.prefetch ? " con pedido adelantado" : "") << "; rondas de " << params.range_size << " llaves por proceso" << endl;
+
+    vector<string> selected = (params.strategy == "todas") ? strategies : vector<string>{params.strategy};
+    for (const string& strategy : selected) {
+        params.strategy = strategy;
+        cout << "\nEstrategia " << strategy << endl;
+        cout << setw(9) << "procesos" << setw(13) << "llaves/s" << setw(11) << "eficiencia" << setw(11) << "procesos%"
+             << setw(10) << "maestro%" << setw(10) << "cola" << setw(16) << "t.encontrar" << setw(14) << "t.detener" << endl;
+
+        for (int ranks : rank_counts) {
+            // Velocidades: mismas para todas las estrategias con la misma semilla
+            mt19937_64 random(params.seed);
+            uniform_real_distribution<double> spread(-params.rate_spread, params.rate_spread);
+            vector<double> rates(ranks);
+            for (double& rate : rates) {
+                rate = params.key_rate * (1 + spread(random));
+            }
+
+            bool dynamic = strategy == "maestro" || strategy == "rma";
+            SimResult result = dynamic ? simulateDynamic(params, rates, random) : simulateStatic(params, rates, random);
+
+            ostringstream queue_text;
+            if (result.mean_queue >= 0) {
+                queue_text << fixed << setprecision(1) << result.mean_queue;
+            } else {
+                queue_text << "-";
+            }
+            cout << setw(9) << ranks << setw(13) << scientific << setprecision(3) << result.throughput << defaultfloat
+                 << setw(11) << percent(result.throughput / result.ideal) << setw(11) << percent(result.worker_util)
+                 << setw(10) << percent(result.server_util) << setw(10) << queue_text.str()
+                 << setw(16) << (formatTime(result.mean_find) + (result.extrapolated ? "*" : "")) << setw(14)
+                 << formatTime(result.stop_delay) << endl;
+        }
+    }
+    cout << "\n* extrapolado con el rendimiento en régimen después del horizonte simulado" << endl;
+    return 0;
+}
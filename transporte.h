@@ -0,0 +1,785 @@
+/*
+Proyecto MPI - Capa de transporte de mensajes
+Grupo 4
+
+Las estrategias de búsqueda (naive, naive-plus, dfs y maestro/esclavo) se comunican a través
+de la interfaz Transport en lugar de llamar directamente a MPI. Hay dos implementaciones:
+    MPITransport:    cada rango es un proceso MPI (mpirun).
+    ThreadTransport: cada rango es un hilo del mismo proceso y los mensajes pasan por colas
+                     sin bloqueos; no necesita MPI ni un lanzador.
+
+Los programas eligen el transporte con la opción "-hilos <n>":
+    mpirun -np 4 ./build/naive.o <archivo>        (MPI)
+    ./build/naive.o <archivo> -hilos 4            (4 hilos, sin MPI)
+
+Con MPI, el rango 0 puede además abrir un puerto (openPort) para que procesos de otros trabajos
+se unan durante la ejecución (joinPort). Cada proceso unido recibe un rango a continuación de
+los del mundo y se comunica con el rango 0 por su propio intercomunicador (MPI_Comm_join).
+*/
+
+#ifndef TRANSPORTE_H
+#define TRANSPORTE_H
+
+#include <mpi.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+const int ANY_SOURCE = -1;
+const int ANY_TAG = -1;
+
+// Recepción preparada que ya se completó (ver Transport::postReceive)
+struct ReceivedMessage {
+    int id;      // Identificador que retornó postReceive
+    int source;
+    int tag;
+    int count;   // Valores recibidos
+};
+
+// Interfaz común de comunicación entre rangos; los mensajes son arreglos de uint64_t
+class Transport {
+public:
+    virtual ~Transport() {}
+
+    virtual int rank() const = 0;
+    virtual int size() const = 0;
+
+    // Envía count valores a dest; nunca bloquea. Retorna false si el destino no es alcanzable.
+    virtual bool send(const uint64_t* data, int count, int dest, int tag) = 0;
+
+    // Busca un mensaje que coincida con source/tag (pueden ser ANY_*). Si wait es true espera a que llegue.
+    virtual bool probe(int source, int tag, int& found_source, int& found_tag, bool wait) = 0;
+
+    // Recibe un mensaje (espera si no hay); retorna la cantidad de valores recibidos
+    virtual int receive(uint64_t* data, int max_count, int source, int tag, int* found_source = nullptr, int* found_tag = nullptr) = 0;
+
+    // Espera a que terminen los envíos pendientes, como máximo timeout segundos
+    virtual bool flush(double timeout) = 0;
+
+    // Recepciones preparadas (como MPI_Irecv): postReceive deja pendiente la recepción de un
+    // mensaje de source/tag en data y retorna su identificador. waitSome espera como máximo
+    // timeout segundos (sin límite si es negativo) a que se complete al menos una y deja las
+    // completadas en completed; cada una se completa una sola vez y se vuelve a preparar con
+    // postReceive. cancelReceives descarta las que siguen pendientes.
+    virtual int postReceive(uint64_t* data, int max_count, int source, int tag) = 0;
+    virtual int waitSome(std::vector<ReceivedMessage>& completed, double timeout) = 0;
+    virtual void cancelReceives() = 0;
+
+    // Todos los rangos aportan un valor y reciben los de todos
+    virtual std::vector<double> allgather(double value) = 0;
+
+    virtual void barrier() = 0;
+
+    // Contador compartido alojado en el rango 0: openCounter y closeCounter son colectivas,
+    // fetchAdd suma value de forma atómica y retorna el valor anterior
+    virtual void openCounter() = 0;
+    virtual uint64_t fetchAdd(uint64_t value) = 0;
+    virtual void closeCounter() = 0;
+
+    // Procesos que se unen durante la ejecución (solo MPI): openPort publica un puerto en
+    // port_file; acceptPeer atiende una conexión pendiente sin esperar y retorna el rango
+    // asignado (-1 si no hay ninguna), al que desde entonces se le envía y se le recibe como a
+    // cualquier otro rango. releasePeer suelta la conexión con un proceso que se va, sin esperarlo
+    // (en el proceso unido, releasePeer(0) suelta la del rango 0), y closePort deja de aceptar.
+    virtual bool openPort(const std::string& port_file) = 0;
+    virtual int acceptPeer() = 0;
+    virtual void releasePeer(int peer) = 0;
+    virtual void closePort() = 0;
+
+    virtual double time() = 0;
+    virtual void abort(int code) = 0;
+
+    // Atajos para las sondas habituales
+    bool iprobe(int source, int tag) {
+        int found_source, found_tag;
+        return probe(source, tag, found_source, found_tag, false);
+    }
+};
+
+/*
+Clase MPITransport
+Descripción:
+    Transporte sobre un comunicador MPI. Los envíos se hacen con MPI_Isend sobre una copia
+    del mensaje, que se libera cuando el envío termina. Los rangos desde size() en adelante son
+    procesos unidos por el puerto: cada uno es el rango 0 remoto de su intercomunicador.
+*/
+class MPITransport : public Transport {
+public:
+    explicit MPITransport(MPI_Comm comm) : comm_(comm) {
+        MPI_Comm_rank(comm_, &rank_);
+        MPI_Comm_size(comm_, &size_);
+
+        // Los errores de comunicación con un proceso caído no deben abortar a los demás
+        MPI_Comm_set_errhandler(comm_, MPI_ERRORS_RETURN);
+    }
+
+    // Proceso unido (joinPort): comm es el intercomunicador con el rango 0 y rank el rango asignado
+    MPITransport(MPI_Comm comm, int rank, int size) : comm_(comm), rank_(rank), size_(size), joined_(true) {
+        MPI_Comm_set_errhandler(comm_, MPI_ERRORS_RETURN);
+    }
+
+    ~MPITransport() override {
+        closePort();
+        flush(1.0);
+        for (MPI_Comm& peer : peers_) {
+            if (peer != MPI_COMM_NULL) {
+                MPI_Comm_disconnect(&peer);
+            }
+        }
+        if (joined_ && comm_ != MPI_COMM_NULL) {
+            MPI_Comm_disconnect(&comm_);
+        }
+    }
+
+    int rank() const override { return rank_; }
+    int size() const override { return size_; }
+
+    bool send(const uint64_t* data, int count, int dest, int tag) override {
+        completeSends();
+        pending_.emplace_back();
+        PendingSend& pending = pending_.back();
+        pending.buffer.assign(data, data + count);
+        if (MPI_Isend(pending.buffer.data(), count, MPI_UINT64_T, remoteRank(dest), tag, commOf(dest), &pending.request) != MPI_SUCCESS) {
+            pending_.pop_back();
+            return false;
+        }
+        return true;
+    }
+
+    bool probe(int source, int tag, int& found_source, int& found_tag, bool wait) override {
+        MPI_Status status;
+        int flag = 1;
+        int mpi_source = (source == ANY_SOURCE) ? MPI_ANY_SOURCE : remoteRank(source);
+        int mpi_tag = (tag == ANY_TAG) ? MPI_ANY_TAG : tag;
+
+        if (wait) {
+            MPI_Probe(mpi_source, mpi_tag, commOf(source), &status);
+        } else {
+            MPI_Iprobe(mpi_source, mpi_tag, commOf(source), &flag, &status);
+        }
+
+        if (flag) {
+            found_source = (source >= size_) ? source : status.MPI_SOURCE;
+            found_tag = status.MPI_TAG;
+        }
+        return flag != 0;
+    }
+
+    int receive(uint64_t* data, int max_count, int source, int tag, int* found_source, int* found_tag) override {
+        MPI_Status status;
+        int count;
+        MPI_Recv(data, max_count, MPI_UINT64_T, (source == ANY_SOURCE) ? MPI_ANY_SOURCE : remoteRank(source),
+                 (tag == ANY_TAG) ? MPI_ANY_TAG : tag, commOf(source), &status);
+        MPI_Get_count(&status, MPI_UINT64_T, &count);
+        if (found_source) *found_source = (source >= size_) ? source : status.MPI_SOURCE;
+        if (found_tag) *found_tag = status.MPI_TAG;
+        return count;
+    }
+
+    bool flush(double timeout) override {
+        double deadline = MPI_Wtime() + timeout;
+        completeSends();
+        while (!pending_.empty() && MPI_Wtime() < deadline) {
+            std::this_thread::yield();
+            completeSends();
+        }
+        return pending_.empty();
+    }
+
+    int postReceive(uint64_t* data, int max_count, int source, int tag) override {
+        size_t id = std::find(posted_.begin(), posted_.end(), MPI_REQUEST_NULL) - posted_.begin();
+        if (id == posted_.size()) {
+            posted_.push_back(MPI_REQUEST_NULL);
+            posted_source_.push_back(ANY_SOURCE);
+        }
+        posted_source_[id] = source;
+        MPI_Irecv(data, max_count, MPI_UINT64_T, (source == ANY_SOURCE) ? MPI_ANY_SOURCE : remoteRank(source),
+                  (tag == ANY_TAG) ? MPI_ANY_TAG : tag, commOf(source), &posted_[id]);
+        return id;
+    }
+
+    // MPI_Waitsome no tiene plazo: con timeout se sondea con MPI_Testsome y pausas cortas
+    int waitSome(std::vector<ReceivedMessage>& completed, double timeout) override {
+        completed.clear();
+        int incount = posted_.size();
+        int outcount = 0;
+        indices_.resize(incount);
+        statuses_.resize(incount);
+        if (timeout < 0) {
+            MPI_Waitsome(incount, posted_.data(), &outcount, indices_.data(), statuses_.data());
+        } else {
+            double deadline = MPI_Wtime() + timeout;
+            MPI_Testsome(incount, posted_.data(), &outcount, indices_.data(), statuses_.data());
+            while (outcount == 0 && MPI_Wtime() < deadline) {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+                MPI_Testsome(incount, posted_.data(), &outcount, indices_.data(), statuses_.data());
+            }
+        }
+        for (int i = 0; i < outcount && outcount != MPI_UNDEFINED; i++) {
+            int count;
+            MPI_Get_count(&statuses_[i], MPI_UINT64_T, &count);
+            int source = (posted_source_[indices_[i]] >= size_) ? posted_source_[indices_[i]] : statuses_[i].MPI_SOURCE;
+            completed.push_back({indices_[i], source, statuses_[i].MPI_TAG, count});
+        }
+        return completed.size();
+    }
+
+    void cancelReceives() override {
+        for (MPI_Request& request : posted_) {
+            if (request != MPI_REQUEST_NULL) {
+                MPI_Cancel(&request);
+                MPI_Wait(&request, MPI_STATUS_IGNORE);
+            }
+        }
+        posted_.clear();
+        posted_source_.clear();
+    }
+
+    std::vector<double> allgather(double value) override {
+        std::vector<double> values(size_);
+        MPI_Allgather(&value, 1, MPI_DOUBLE, values.data(), 1, MPI_DOUBLE, comm_);
+        return values;
+    }
+
+    void barrier() override { MPI_Barrier(comm_); }
+
+    // El contador es una ventana RMA de un uint64_t en el rango 0, con acceso pasivo (lock_all)
+    void openCounter() override {
+        uint64_t* base;
+        MPI_Win_allocate(rank_ == 0 ? sizeof(uint64_t) : 0, sizeof(uint64_t), MPI_INFO_NULL, comm_, &base, &counter_);
+        if (rank_ == 0) {
+            *base = 0;
+        }
+        MPI_Barrier(comm_);
+        MPI_Win_lock_all(0, counter_);
+    }
+
+    uint64_t fetchAdd(uint64_t value) override {
+        uint64_t previous;
+        MPI_Fetch_and_op(&value, &previous, MPI_UINT64_T, 0, 0, MPI_SUM, counter_);
+        MPI_Win_flush(0, counter_);
+        return previous;
+    }
+
+    void closeCounter() override {
+        MPI_Win_unlock_all(counter_);
+        MPI_Win_free(&counter_);
+    }
+
+    // El puerto es un socket TCP que se revisa sin bloquear; MPI_Comm_accept no tiene versión
+    // no bloqueante. "<host> <puerto>" se escribe en un archivo temporal que luego se renombra,
+    // para que quien lo lee nunca vea una dirección a medias.
+    bool openPort(const std::string& port_file) override {
+        sockaddr_in address = {};
+        socklen_t length = sizeof(address);
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        listener_ = socket(AF_INET, SOCK_STREAM, 0);
+        if (listener_ < 0 || bind(listener_, (sockaddr*)&address, sizeof(address)) != 0 || listen(listener_, 64) != 0 ||
+            getsockname(listener_, (sockaddr*)&address, &length) != 0) {
+            closePort();
+            return false;
+        }
+        fcntl(listener_, F_SETFL, O_NONBLOCK);
+
+        char host[256] = "localhost";
+        gethostname(host, sizeof(host) - 1);
+        std::string partial = port_file + ".tmp";
+        std::ofstream file(partial);
+        file << host << " " << ntohs(address.sin_port) << "\n";
+        file.close();
+        if (file.fail() || std::rename(partial.c_str(), port_file.c_str()) != 0) {
+            closePort();
+            return false;
+        }
+        port_file_ = port_file;
+        return true;
+    }
+
+    // Revisa el puerto como máximo una vez cada accept_interval segundos. Con una conexión
+    // pendiente, MPI_Comm_join arma el intercomunicador (el proceso ya está esperando, así
+    // que tarda lo que un intercambio de mensajes) y se le comunica el rango asignado.
+    int acceptPeer() override {
+        if (listener_ < 0 || MPI_Wtime() < next_accept_) {
+            return -1;
+        }
+        next_accept_ = MPI_Wtime() + accept_interval;
+
+        int connection = accept(listener_, nullptr, nullptr);
+        if (connection < 0) {
+            return -1;
+        }
+        timeval timeout = {accept_timeout, 0};  // Un proceso que se cae a medio unirse no detiene al rango 0
+        setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        MPI_Comm peer;
+        MPI_Comm_set_errhandler(MPI_COMM_SELF, MPI_ERRORS_RETURN);
+        int joined = MPI_Comm_join(connection, &peer);
+        ::close(connection);
+        if (joined != MPI_SUCCESS) {
+            return -1;
+        }
+
+        MPI_Comm_set_errhandler(peer, MPI_ERRORS_RETURN);
+        int assigned[2] = {size_ + (int)peers_.size(), size_};
+        MPI_Send(assigned, 2, MPI_INT, 0, 0, peer);
+        peers_.push_back(peer);
+        return assigned[0];
+    }
+
+    // MPI_Comm_disconnect es colectivo y detendría el ciclo del maestro hasta que el otro lado
+    // llegue a la misma llamada; MPI_Comm_free es local y deja terminar los envíos pendientes.
+    // Ambos lados liberan el intercomunicador, así ninguno queda esperando al otro al salir.
+    // No debe haber recepciones pendientes del proceso que se va.
+    void releasePeer(int peer) override {
+        if (joined_ && peer == 0 && comm_ != MPI_COMM_NULL) {
+            MPI_Comm_free(&comm_);
+        } else if (!joined_ && peer >= size_ && peer - size_ < (int)peers_.size() && peers_[peer - size_] != MPI_COMM_NULL) {
+            MPI_Comm_free(&peers_[peer - size_]);
+        }
+    }
+
+    // Las conexiones que quedaron en la cola del socket se rechazan al cerrarlo
+    void closePort() override {
+        if (listener_ >= 0) {
+            ::close(listener_);
+            listener_ = -1;
+        }
+        if (!port_file_.empty()) {
+            unlink(port_file_.c_str());
+            port_file_.clear();
+        }
+    }
+
+    double time() override { return MPI_Wtime(); }
+    void abort(int code) override { MPI_Abort(comm_, code); }
+
+private:
+    struct PendingSend {
+        std::vector<uint64_t> buffer;
+        MPI_Request request;
+    };
+
+    // Comunicador y rango remoto con que se alcanza a un rango (los unidos por su intercomunicador)
+    MPI_Comm commOf(int rank) const {
+        return (rank >= size_ && !joined_) ? peers_[rank - size_] : comm_;
+    }
+    int remoteRank(int rank) const {
+        return (rank >= size_ && !joined_) ? 0 : rank;
+    }
+
+    // Libera los envíos que ya terminaron
+    void completeSends() {
+        for (auto it = pending_.begin(); it != pending_.end();) {
+            int done = 0;
+            MPI_Test(&it->request, &done, MPI_STATUS_IGNORE);
+            it = done ? pending_.erase(it) : std::next(it);
+        }
+    }
+
+    MPI_Comm comm_;
+    int rank_;
+    int size_;
+    std::list<PendingSend> pending_;
+    std::vector<MPI_Request> posted_;  // Recepciones preparadas (MPI_REQUEST_NULL si el lugar está libre)
+    std::vector<int> posted_source_;   // Origen pedido en cada recepción preparada
+    std::vector<int> indices_;
+    std::vector<MPI_Status> statuses_;
+    MPI_Win counter_ = MPI_WIN_NULL;
+
+    bool joined_ = false;               // Este proceso se unió por un puerto (comm_ es el intercomunicador)
+    std::vector<MPI_Comm> peers_;       // Intercomunicador de cada proceso unido (MPI_COMM_NULL si se fue)
+    int listener_ = -1;                 // Socket del puerto, -1 si está cerrado
+    std::string port_file_;
+    double next_accept_ = 0;            // Próxima revisión del puerto
+
+    static constexpr double accept_interval = 0.01;  // Segundos entre revisiones del puerto
+    static const int accept_timeout = 10;            // Segundos máximos de MPI_Comm_join
+};
+
+// Mensaje en tránsito entre hilos
+struct ThreadMessage {
+    int source;
+    int tag;
+    std::vector<uint64_t> data;
+    ThreadMessage* next;
+};
+
+/*
+Clase ThreadHub
+Descripción:
+    Estado compartido por los hilos-rango: un buzón por rango y los datos de las operaciones
+    colectivas. Cada buzón es una pila sin bloqueos (varios productores con compare-and-swap,
+    un solo consumidor que la vacía de una vez con exchange).
+*/
+class ThreadHub {
+public:
+    explicit ThreadHub(int size) : size_(size), mailboxes_(size), gathered_(size) {
+        for (auto& mailbox : mailboxes_) {
+            mailbox.store(nullptr);
+        }
+    }
+
+    ~ThreadHub() {
+        for (auto& mailbox : mailboxes_) {
+            ThreadMessage* message = mailbox.exchange(nullptr);
+            while (message) {
+                ThreadMessage* next = message->next;
+                delete message;
+                message = next;
+            }
+        }
+    }
+
+    int size() const { return size_; }
+
+    void push(int dest, ThreadMessage* message) {
+        ThreadMessage* head = mailboxes_[dest].load(std::memory_order_relaxed);
+        do {
+            message->next = head;
+        } while (!mailboxes_[dest].compare_exchange_weak(head, message, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // Retorna los mensajes llegados a dest en orden de llegada
+    ThreadMessage* takeAll(int dest) {
+        ThreadMessage* stack = mailboxes_[dest].exchange(nullptr, std::memory_order_acquire);
+        ThreadMessage* ordered = nullptr;
+        while (stack) {
+            ThreadMessage* next = stack->next;
+            stack->next = ordered;
+            ordered = stack;
+            stack = next;
+        }
+        return ordered;
+    }
+
+    // Barrera reutilizable por generaciones
+    void barrier() {
+        std::unique_lock<std::mutex> lock(barrier_mutex_);
+        int generation = barrier_generation_;
+        if (++barrier_count_ == size_) {
+            barrier_count_ = 0;
+            barrier_generation_++;
+            barrier_cv_.notify_all();
+        } else {
+            barrier_cv_.wait(lock, [&] { return generation != barrier_generation_; });
+        }
+    }
+
+    void openCounter() {
+        barrier();
+        counter_.store(0);
+        barrier();
+    }
+
+    uint64_t fetchAdd(uint64_t value) { return counter_.fetch_add(value); }
+
+    std::vector<double> allgather(int rank, double value) {
+        gathered_[rank] = value;
+        barrier();
+        std::vector<double> values = gathered_;
+        barrier();
+        return values;
+    }
+
+private:
+    int size_;
+    std::vector<std::atomic<ThreadMessage*>> mailboxes_;
+    std::vector<double> gathered_;
+    std::mutex barrier_mutex_;
+    std::condition_variable barrier_cv_;
+    int barrier_count_ = 0;
+    int barrier_generation_ = 0;
+    std::atomic<uint64_t> counter_{0};
+};
+
+/*
+Clase ThreadTransport
+Descripción:
+    Transporte de un hilo-rango. Los mensajes que se sacan del buzón y aún no se reciben quedan
+    en una cola local, de modo que probe/receive pueden filtrar por origen y etiqueta
+    conservando el orden entre un mismo par de rangos, como en MPI.
+*/
+class ThreadTransport : public Transport {
+public:
+    ThreadTransport(ThreadHub& hub, int rank) : hub_(hub), rank_(rank) {}
+
+    ~ThreadTransport() override {
+        for (ThreadMessage* message : local_) {
+            delete message;
+        }
+    }
+
+    int rank() const override { return rank_; }
+    int size() const override { return hub_.size(); }
+
+    bool send(const uint64_t* data, int count, int dest, int tag) override {
+        ThreadMessage* message = new ThreadMessage{rank_, tag, std::vector<uint64_t>(data, data + count), nullptr};
+        hub_.push(dest, message);
+        return true;
+    }
+
+    bool probe(int source, int tag, int& found_source, int& found_tag, bool wait) override {
+        while (true) {
+            auto it = find(source, tag);
+            if (it != local_.end()) {
+                found_source = (*it)->source;
+                found_tag = (*it)->tag;
+                return true;
+            }
+            if (!wait) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    int receive(uint64_t* data, int max_count, int source, int tag, int* found_source, int* found_tag) override {
+        int message_source, message_tag;
+        probe(source, tag, message_source, message_tag, true);
+
+        auto it = find(source, tag);
+        ThreadMessage* message = *it;
+        local_.erase(it);
+
+        int count = std::min<int>(max_count, message->data.size());
+        std::memcpy(data, message->data.data(), count * sizeof(uint64_t));
+        if (found_source) *found_source = message->source;
+        if (found_tag) *found_tag = message->tag;
+        delete message;
+        return count;
+    }
+
+    bool flush(double) override { return true; }
+
+    int postReceive(uint64_t* data, int max_count, int source, int tag) override {
+        size_t id = 0;
+        while (id < posted_.size() && posted_[id].active) {
+            id++;
+        }
+        if (id == posted_.size()) {
+            posted_.emplace_back();
+        }
+        posted_[id] = PostedReceive{data, max_count, source, tag, true};
+        return id;
+    }
+
+    // Las recepciones preparadas toman los mensajes en el orden en que se prepararon, como en MPI
+    int waitSome(std::vector<ReceivedMessage>& completed, double timeout) override {
+        completed.clear();
+        double deadline = time() + timeout;
+        while (true) {
+            for (size_t id = 0; id < posted_.size(); id++) {
+                PostedReceive& posted = posted_[id];
+                if (!posted.active) {
+                    continue;
+                }
+                auto it = find(posted.source, posted.tag);
+                if (it == local_.end()) {
+                    continue;
+                }
+                ThreadMessage* message = *it;
+                local_.erase(it);
+                int count = std::min<int>(posted.max_count, message->data.size());
+                std::memcpy(posted.data, message->data.data(), count * sizeof(uint64_t));
+                completed.push_back({(int)id, message->source, message->tag, count});
+                posted.active = false;
+                delete message;
+            }
+            if (!completed.empty() || (timeout >= 0 && time() >= deadline)) {
+                return completed.size();
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    void cancelReceives() override { posted_.clear(); }
+
+    std::vector<double> allgather(double value) override { return hub_.allgather(rank_, value); }
+    void barrier() override { hub_.barrier(); }
+
+    void openCounter() override { hub_.openCounter(); }
+    uint64_t fetchAdd(uint64_t value) override { return hub_.fetchAdd(value); }
+    void closeCounter() override { hub_.barrier(); }
+
+    // Los hilos-rango no pueden recibir procesos externos
+    bool openPort(const std::string&) override { return false; }
+    int acceptPeer() override { return -1; }
+    void releasePeer(int) override {}
+    void closePort() override {}
+
+    // Reloj común a todos los hilos (las trazas y los plazos se comparan entre rangos)
+    double time() override {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void abort(int code) override { std::_Exit(code); }
+
+private:
+    // Pasa los mensajes del buzón a la cola local y busca el primero que coincida
+    std::deque<ThreadMessage*>::iterator find(int source, int tag) {
+        for (ThreadMessage* message = hub_.takeAll(rank_); message;) {
+            ThreadMessage* next = message->next;
+            local_.push_back(message);
+            message = next;
+        }
+        for (auto it = local_.begin(); it != local_.end(); ++it) {
+            if ((source == ANY_SOURCE || (*it)->source == source) && (tag == ANY_TAG || (*it)->tag == tag)) {
+                return it;
+            }
+        }
+        return local_.end();
+    }
+
+    struct PostedReceive {
+        uint64_t* data;
+        int max_count;
+        int source;
+        int tag;
+        bool active;
+    };
+
+    ThreadHub& hub_;
+    int rank_;
+    std::deque<ThreadMessage*> local_;
+    std::vector<PostedReceive> posted_;
+};
+
+/*
+Función extractThreadsOption
+Parámetros:
+    argc, argv: argumentos del programa
+Descripción:
+    Busca la opción "-hilos <n>" y la quita de argv para que el resto del programa no la vea.
+Retorno:
+    int, cantidad de hilos-rango (0 si se usa MPI)
+*/
+inline int extractThreadsOption(int& argc, char** argv) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::strcmp(argv[i], "-hilos") == 0) {
+            int threads = std::max(1, std::atoi(argv[i + 1]));
+            for (int j = i; j + 2 <= argc; j++) {
+                argv[j] = argv[j + 2];
+            }
+            argc -= 2;
+            return threads;
+        }
+    }
+    return 0;
+}
+
+/*
+Función initRuntime
+Descripción:
+    Inicializa MPI si no se usan hilos y obtiene rango y tamaño del mundo.
+*/
+inline void initRuntime(int& argc, char**& argv, int threads, int& rank, int& size) {
+    if (threads == 0) {
+        MPI_Init(&argc, &argv);
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &size);
+    } else {
+        rank = 0;
+        size = threads;
+    }
+}
+
+inline void finalizeRuntime(int threads) {
+    if (threads == 0) {
+        MPI_Finalize();
+    }
+}
+
+/*
+Función joinPort
+Parámetros:
+    port_file: string, archivo donde el rango 0 de otro trabajo publicó su puerto (openPort)
+Descripción:
+    Conecta este proceso (con MPI ya inicializado) al trabajo que abrió el puerto y espera a que
+    el rango 0 lo acepte y le asigne un rango.
+Retorno:
+    MPITransport*, transporte hacia el rango 0, o nullptr si no se pudo conectar o fue rechazado
+*/
+inline MPITransport* joinPort(const std::string& port_file) {
+    std::ifstream file(port_file);
+    std::string host, port;
+    if (!(file >> host >> port)) {
+        return nullptr;
+    }
+
+    addrinfo hints = {};
+    addrinfo* addresses;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0) {
+        return nullptr;
+    }
+    int connection = socket(AF_INET, SOCK_STREAM, 0);
+    bool connected = connection >= 0 && connect(connection, addresses->ai_addr, addresses->ai_addrlen) == 0;
+    freeaddrinfo(addresses);
+
+    // MPI_Comm_join espera a que el rango 0 atienda la conexión; falla si cierra el puerto antes
+    MPI_Comm comm;
+    MPI_Comm_set_errhandler(MPI_COMM_SELF, MPI_ERRORS_RETURN);
+    bool joined = connected && MPI_Comm_join(connection, &comm) == MPI_SUCCESS;
+    if (connection >= 0) {
+        ::close(connection);
+    }
+    if (!joined) {
+        return nullptr;
+    }
+
+    int assigned[2];  // Rango asignado y tamaño del mundo del otro trabajo
+    if (MPI_Recv(assigned, 2, MPI_INT, 0, 0, comm, MPI_STATUS_IGNORE) != MPI_SUCCESS) {
+        MPI_Comm_disconnect(&comm);
+        return nullptr;
+    }
+    return new MPITransport(comm, assigned[0], assigned[1]);
+}
+
+/*
+Función runRanks
+Parámetros:
+    threads: int, 0 para MPI o cantidad de hilos-rango
+    body: función que ejecuta la estrategia con un Transport
+Descripción:
+    Con MPI ejecuta body una vez en el proceso actual; con hilos lanza un hilo por rango,
+    cada uno con su propio ThreadTransport, y espera a que todos terminen.
+*/
+template <typename Body>
+void runRanks(int threads, Body body) {
+    if (threads == 0) {
+        MPITransport transport(MPI_COMM_WORLD);
+        body(transport);
+        return;
+    }
+
+    ThreadHub hub(threads);
+    std::vector<std::thread> workers;
+    for (int r = 0; r < threads; r++) {
+        workers.emplace_back([&hub, &body, r]() {
+            ThreadTransport transport(hub, r);
+            body(transport);
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+#endif